@@ -0,0 +1,127 @@
+#include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/sync/pool.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations {0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* result = std::malloc(size == 0 ? 1 : size)) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using namespace yamail::resource_pool;
+
+struct resource {
+    std::int64_t value = 0;
+};
+
+class allocations_counter {
+public:
+    explicit allocations_counter(benchmark::State& state) : state_(state), before_(allocations.load()) {}
+
+    ~allocations_counter() {
+        state_.counters["allocations"] = benchmark::Counter(static_cast<double>(allocations.load() - before_),
+            benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& state_;
+    std::size_t before_;
+};
+
+template <class Pool>
+void sync_get_auto_recycle(benchmark::State& state) {
+    Pool pool(1);
+    const allocations_counter counter(state);
+    for (auto _ : state) {
+        auto result = pool.get_auto_recycle();
+        if (result.second.empty()) {
+            result.second.reset(resource {});
+        }
+        benchmark::DoNotOptimize(++result.second->value);
+    }
+}
+
+template <class Pool>
+void sync_get_auto_waste(benchmark::State& state) {
+    Pool pool(1);
+    const allocations_counter counter(state);
+    for (auto _ : state) {
+        auto result = pool.get_auto_waste();
+        result.second.reset(resource {});
+        benchmark::DoNotOptimize(++result.second->value);
+    }
+}
+
+using async_pool = async::pool<resource>;
+
+void async_get_auto_recycle(benchmark::State& state) {
+    boost::asio::io_context io;
+    async_pool pool(1, 1);
+    const allocations_counter counter(state);
+    for (auto _ : state) {
+        pool.get_auto_recycle(io, [] (boost::system::error_code ec, async_pool::handle handle) {
+            if (!ec && handle.empty()) {
+                handle.reset(resource {});
+            }
+        });
+        io.restart();
+        io.run();
+    }
+}
+
+void async_get_auto_recycle_queued(benchmark::State& state) {
+    boost::asio::io_context io;
+    async_pool pool(1, 1);
+    async_pool::handle held;
+    const auto on_get = [&] (boost::system::error_code ec, async_pool::handle handle) {
+        if (!ec) {
+            if (handle.empty()) {
+                handle.reset(resource {});
+            }
+            held = std::move(handle);
+        }
+    };
+    pool.get_auto_recycle(io, on_get);
+    io.run();
+    const allocations_counter counter(state);
+    for (auto _ : state) {
+        pool.get_auto_recycle(io, on_get, std::chrono::seconds(1));
+        held.recycle();
+        io.restart();
+        io.run();
+    }
+}
+
+}
+
+BENCHMARK_TEMPLATE(sync_get_auto_recycle, sync::pool<resource>);
+BENCHMARK_TEMPLATE(sync_get_auto_recycle, sync::fair_pool<resource>);
+BENCHMARK_TEMPLATE(sync_get_auto_waste, sync::pool<resource>);
+BENCHMARK_TEMPLATE(sync_get_auto_waste, sync::fair_pool<resource>);
+BENCHMARK(async_get_auto_recycle);
+BENCHMARK(async_get_auto_recycle_queued);
+
+BENCHMARK_MAIN();
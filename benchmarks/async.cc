@@ -1,4 +1,8 @@
+#include "latency.hpp"
+
 #include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/instrumented_mutex.hpp>
+#include <yamail/resource_pool/virtual_clock.hpp>
 
 #include <benchmark/benchmark.h>
 
@@ -11,6 +15,10 @@
 #include <random>
 #include <thread>
 
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
 namespace {
 
 using namespace yamail::resource_pool;
@@ -84,7 +92,7 @@ struct context {
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard = boost::asio::make_work_guard(io_context);
     std::conditional_t<std::is_same_v<Threading, multi_thread>, std::atomic_bool, bool> stop {false};
     time_traits::duration timeout {std::chrono::milliseconds(100)};
-    std::vector<std::chrono::steady_clock::duration> durations;
+    benchmarks::latencies latencies;
     std::mutex get_next_mutex;
     std::condition_variable get_next;
     std::unique_lock<std::mutex> get_next_lock {get_next_mutex};
@@ -109,10 +117,12 @@ struct context {
     }
 };
 
-template <class Threading>
+template <class Threading, class QueueKind = async::deadline_ordered_queue>
 struct callback {
     using mutex_t = std::conditional_t<std::is_same_v<Threading, multi_thread>, std::mutex, stub_mutex>;
-    using pool_t = async::pool<resource, mutex_t>;
+    using pool_t = async::pool<resource, mutex_t, boost::asio::io_context,
+        typename async::default_pool_impl<resource, mutex_t, boost::asio::io_context, async::fifo_handoff,
+            detail::storage<resource>, null_observer, QueueKind>::type>;
     using handle_t = typename pool_t::handle;
 
     context<Threading>& ctx;
@@ -142,6 +152,30 @@ struct callback {
     }
 };
 
+template <class Threading>
+struct latency_callback {
+    using pool_t = typename callback<Threading>::pool_t;
+    using handle_t = typename callback<Threading>::handle_t;
+
+    context<Threading>& ctx;
+    pool_t& pool;
+    std::chrono::steady_clock::time_point requested_at {};
+
+    void operator ()(const boost::system::error_code& ec, handle_t handle) {
+        ctx.latencies.add(std::chrono::steady_clock::now() - requested_at);
+        callback<Threading> {ctx, pool}.impl(ec, std::move(handle));
+        if (!ctx.stop) {
+            request();
+        }
+        ctx.allow_next();
+    }
+
+    void request() {
+        requested_at = std::chrono::steady_clock::now();
+        pool.get_auto_waste(ctx.io_context, *this, ctx.timeout);
+    }
+};
+
 const std::array<benchmark_args, 17> benchmarks{{
     benchmark_args().sequences(1).threads(1).resources(1).queue_size(0), // 0
     benchmark_args().sequences(2).threads(1).resources(1).queue_size(1), // 1
@@ -162,11 +196,12 @@ const std::array<benchmark_args, 17> benchmarks{{
     benchmark_args().sequences(10000).threads(2).resources(10).queue_size(9990), // 16
 }};
 
+template <class QueueKind>
 void get_auto_waste_callbacks_st(benchmark::State& state) {
     const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
     context<single_thread> ctx;
-    async::pool<resource, stub_mutex> pool(args.resources(), args.queue_size());
-    callback<single_thread> cb {ctx, pool};
+    typename callback<single_thread, QueueKind>::pool_t pool(args.resources(), args.queue_size());
+    callback<single_thread, QueueKind> cb {ctx, pool};
     for (std::size_t i = 0; i < args.sequences(); ++i) {
         pool.get_auto_waste(ctx.io_context, cb, ctx.timeout);
     }
@@ -187,15 +222,16 @@ struct thread_context {
         : thread([this] { this->impl.io_context.run(); }) {}
 };
 
+template <class QueueKind>
 void get_auto_waste_callbacks_mt(benchmark::State& state) {
     const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
     std::vector<std::unique_ptr<thread_context>> threads;
     for (std::size_t i = 0; i < args.threads(); ++i) {
         threads.emplace_back(std::make_unique<thread_context>());
     }
-    async::pool<resource> pool(args.resources(), args.queue_size());
+    typename callback<multi_thread, QueueKind>::pool_t pool(args.resources(), args.queue_size());
     for (const auto& ctx : threads) {
-        callback<multi_thread> cb {ctx->impl, pool};
+        callback<multi_thread, QueueKind> cb {ctx->impl, pool};
         for (std::size_t i = 0; i < args.sequences(); ++i) {
             pool.get_auto_waste(ctx->impl.io_context, cb, ctx->impl.timeout);
         }
@@ -207,12 +243,69 @@ void get_auto_waste_callbacks_mt(benchmark::State& state) {
     std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->thread.join(); });
 }
 
+template <class QueueKind>
+void get_auto_waste_queue(benchmark::State& state) {
+    const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
+    if (args.threads() > 1) {
+        get_auto_waste_callbacks_mt<QueueKind>(state);
+    } else {
+        get_auto_waste_callbacks_st<QueueKind>(state);
+    }
+}
+
 void get_auto_waste_callbacks(benchmark::State& state) {
+    get_auto_waste_queue<async::deadline_ordered_queue>(state);
+}
+
+void get_auto_waste_latencies_st(benchmark::State& state) {
+    const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
+    context<single_thread> ctx;
+    async::pool<resource, stub_mutex> pool(args.resources(), args.queue_size());
+    ctx.latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+    for (std::size_t i = 0; i < args.sequences(); ++i) {
+        latency_callback<single_thread> {ctx, pool}.request();
+    }
+    while (state.KeepRunning()) {
+        const auto ready_count = ctx.ready_count;
+        do {
+            ctx.io_context.run_one();
+        } while (ready_count == ctx.ready_count);
+    }
+    ctx.finish();
+    ctx.latencies.report(state);
+}
+
+void get_auto_waste_latencies_mt(benchmark::State& state) {
+    const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
+    std::vector<std::unique_ptr<thread_context>> threads;
+    for (std::size_t i = 0; i < args.threads(); ++i) {
+        threads.emplace_back(std::make_unique<thread_context>());
+    }
+    async::pool<resource> pool(args.resources(), args.queue_size());
+    for (const auto& ctx : threads) {
+        ctx->impl.latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+        for (std::size_t i = 0; i < args.sequences(); ++i) {
+            boost::asio::post(ctx->impl.io_context, [&] { latency_callback<multi_thread> {ctx->impl, pool}.request(); });
+        }
+    }
+    while (state.KeepRunning()) {
+        std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->impl.wait_next(); });
+    }
+    std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->impl.finish(); });
+    std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->thread.join(); });
+    benchmarks::latencies merged;
+    for (const auto& ctx : threads) {
+        merged.merge(ctx->impl.latencies);
+    }
+    merged.report(state);
+}
+
+void get_auto_waste_latencies(benchmark::State& state) {
     const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
     if (args.threads() > 1) {
-        get_auto_waste_callbacks_mt(state);
+        get_auto_waste_latencies_mt(state);
     } else {
-        get_auto_waste_callbacks_st(state);
+        get_auto_waste_latencies_st(state);
     }
 }
 
@@ -290,10 +383,153 @@ void get_auto_waste_coroutines_mt(benchmark::State& state) {
 void get_auto_waste_coroutines(benchmark::State& state) {
     const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
     if (args.threads() > 1) {
-        get_auto_waste_coroutines_st(state);
-    } else {
         get_auto_waste_coroutines_mt(state);
+    } else {
+        get_auto_waste_coroutines_st(state);
+    }
+}
+
+struct owned_resource {
+    std::thread::id owner;
+};
+
+template <class Handoff, class Mutex = std::mutex>
+struct handoff_callback {
+    using pool_t = async::pool<owned_resource, Mutex, boost::asio::io_context,
+        typename async::default_pool_impl<owned_resource, Mutex, boost::asio::io_context, Handoff>::type>;
+    using handle_t = typename pool_t::handle;
+
+    context<multi_thread>& ctx;
+    pool_t& pool;
+    std::atomic<std::int64_t>& acquired;
+    std::atomic<std::int64_t>& cross_thread;
+
+    void operator ()(const boost::system::error_code& ec, handle_t handle) {
+        if (!ec) {
+            const auto this_thread = std::this_thread::get_id();
+            if (handle.empty()) {
+                handle.reset(owned_resource {this_thread});
+            } else {
+                ++acquired;
+                if (handle->owner != this_thread) {
+                    ++cross_thread;
+                    handle->owner = this_thread;
+                }
+            }
+            handle.recycle();
+        }
+        if (!ctx.stop) {
+            pool.get_auto_waste(ctx.io_context, *this, ctx.timeout);
+        }
+        ctx.allow_next();
+    }
+};
+
+template <class Handoff>
+void get_auto_waste_handoffs(benchmark::State& state) {
+    const auto& args = benchmarks[static_cast<std::size_t>(state.range(0))];
+    std::vector<std::unique_ptr<thread_context>> threads;
+    for (std::size_t i = 0; i < args.threads(); ++i) {
+        threads.emplace_back(std::make_unique<thread_context>());
+    }
+    std::atomic<std::int64_t> acquired {0};
+    std::atomic<std::int64_t> cross_thread {0};
+    typename handoff_callback<Handoff>::pool_t pool(args.resources(), args.queue_size());
+    for (const auto& ctx : threads) {
+        handoff_callback<Handoff> cb {ctx->impl, pool, acquired, cross_thread};
+        for (std::size_t i = 0; i < args.sequences(); ++i) {
+            pool.get_auto_waste(ctx->impl.io_context, cb, ctx->impl.timeout);
+        }
+    }
+    while (state.KeepRunning()) {
+        std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->impl.wait_next(); });
+    }
+    std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->impl.finish(); });
+    std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->thread.join(); });
+    state.counters["cross_thread_handoffs"] = benchmark::Counter(
+        acquired == 0 ? 0.0 : static_cast<double>(cross_thread) / static_cast<double>(acquired));
+}
+
+void pin_to_core(std::thread& thread, std::size_t core) {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core % CPU_SETSIZE, &cpu_set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+#else
+    static_cast<void>(thread);
+    static_cast<void>(core);
+#endif
+}
+
+std::size_t cores() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void get_auto_waste_scaling(benchmark::State& state) {
+    using callback_t = handoff_callback<async::fifo_handoff, instrumented_mutex<>>;
+    constexpr std::size_t sequences_per_thread = 4;
+    const auto threads_count = static_cast<std::size_t>(state.range(0));
+    const auto resources = static_cast<std::size_t>(state.range(1));
+    std::vector<std::unique_ptr<thread_context>> threads;
+    for (std::size_t i = 0; i < threads_count; ++i) {
+        threads.emplace_back(std::make_unique<thread_context>());
+        pin_to_core(threads.back()->thread, i % cores());
+    }
+    std::atomic<std::int64_t> acquired {0};
+    std::atomic<std::int64_t> cross_thread {0};
+    callback_t::pool_t pool(resources, threads_count * sequences_per_thread);
+    for (const auto& ctx : threads) {
+        callback_t cb {ctx->impl, pool, acquired, cross_thread};
+        for (std::size_t i = 0; i < sequences_per_thread; ++i) {
+            pool.get_auto_waste(ctx->impl.io_context, cb, ctx->impl.timeout);
+        }
+    }
+    while (state.KeepRunning()) {
+        std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->impl.wait_next(); });
     }
+    std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->impl.finish(); });
+    std::for_each(threads.begin(), threads.end(), [] (const auto& ctx) { ctx->thread.join(); });
+    const auto stats = pool.stats();
+    const auto ratio = [] (std::uint64_t part, std::uint64_t total) {
+        return total == 0 ? 0.0 : static_cast<double>(part) / static_cast<double>(total);
+    };
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["cross_thread_handoffs"] = ratio(std::uint64_t(cross_thread), std::uint64_t(acquired));
+    state.counters["pool_lock_contended"] = ratio(stats.mutex.contended, stats.mutex.acquisitions);
+    state.counters["queue_lock_contended"] = ratio(stats.queue_mutex.contended, stats.queue_mutex.acquisitions);
+}
+
+void get_auto_waste_virtual_expiry(benchmark::State& state) {
+    using pool_t = async::timed_pool<resource, virtual_time_traits>;
+    const auto waiters = static_cast<std::size_t>(state.range(0));
+    const time_traits::duration period = std::chrono::hours(1);
+    constexpr std::size_t steps = 60;
+    for (auto _ : state) {
+        virtual_clock::reset();
+        boost::asio::io_context io_context;
+        pool_t pool(1, waiters);
+        pool_t::handle held;
+        pool.get_auto_waste(io_context, [&] (const boost::system::error_code&, pool_t::handle handle) {
+            held = std::move(handle);
+        });
+        std::size_t expired = 0;
+        for (std::size_t i = 1; i <= waiters; ++i) {
+            pool.get_auto_waste(io_context, [&] (const boost::system::error_code& ec, pool_t::handle) {
+                expired += ec == error::get_resource_timeout;
+            }, period * i / waiters);
+        }
+        for (std::size_t i = 0; i < steps; ++i) {
+            virtual_clock::advance(period / steps);
+            io_context.restart();
+            io_context.poll();
+        }
+        if (expired != waiters) {
+            state.SkipWithError("not all waiters expired");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
 }
 
 void all_benchmarks(benchmark::internal::Benchmark* b) {
@@ -302,9 +538,47 @@ void all_benchmarks(benchmark::internal::Benchmark* b) {
     }
 }
 
+void multi_thread_benchmarks(benchmark::internal::Benchmark* b) {
+    for (std::size_t n = 0; n < benchmarks.size(); ++n) {
+        if (benchmarks[n].threads() > 1) {
+            b->Arg(static_cast<int>(n));
+        }
+    }
+}
+
+void high_queue_benchmarks(benchmark::internal::Benchmark* b) {
+    for (std::size_t n = 0; n < benchmarks.size(); ++n) {
+        if (benchmarks[n].queue_size() >= 90) {
+            b->Arg(static_cast<int>(n));
+        }
+    }
+}
+
+void scaling_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->ArgNames({"threads", "resources"});
+    // Powers of two up to number of cores and number of cores itself, so threads never share a core.
+    const auto max_threads = cores();
+    for (std::size_t threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+        for (const int resources : {1, 16}) {
+            b->Args({static_cast<int>(threads), resources});
+        }
+        if (threads == max_threads) {
+            break;
+        }
+    }
+}
+
 }
 
 BENCHMARK(get_auto_waste_callbacks)->Apply(all_benchmarks);
 BENCHMARK(get_auto_waste_coroutines)->Apply(all_benchmarks);
+BENCHMARK(get_auto_waste_latencies)->Apply(all_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_waste_handoffs, async::fifo_handoff)->Apply(multi_thread_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_waste_handoffs, async::affinity_handoff<8>)->Apply(multi_thread_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_waste_queue, async::deadline_ordered_queue)->Apply(high_queue_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_waste_queue, async::ring_buffer_queue)->Apply(high_queue_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_waste_queue, async::combined_lock_queue)->Apply(high_queue_benchmarks);
+BENCHMARK(get_auto_waste_scaling)->Apply(scaling_benchmarks);
+BENCHMARK(get_auto_waste_virtual_expiry)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
 
 BENCHMARK_MAIN();
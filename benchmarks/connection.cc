@@ -0,0 +1,244 @@
+#include "latency.hpp"
+
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using tcp = asio::ip::tcp;
+
+struct connection_args {
+    std::size_t request_size = 0;
+    std::chrono::microseconds server_latency {0};
+    std::chrono::microseconds setup_cost {0};
+};
+
+void wait(asio::steady_timer& timer, std::chrono::microseconds duration, asio::yield_context yield) {
+    if (duration.count() > 0) {
+        timer.expires_after(duration);
+        timer.async_wait(yield);
+    }
+}
+
+class echo_server {
+public:
+    explicit echo_server(const connection_args& args)
+            : args_(args),
+              acceptor_(io_context_, tcp::endpoint(asio::ip::address_v4::loopback(), 0)) {
+        asio::spawn(io_context_, [this] (asio::yield_context yield) { accept(yield); });
+        thread_ = std::thread([this] { io_context_.run(); });
+    }
+
+    ~echo_server() {
+        io_context_.stop();
+        thread_.join();
+    }
+
+    tcp::endpoint endpoint() const { return acceptor_.local_endpoint(); }
+
+private:
+    const connection_args args_;
+    asio::io_context io_context_;
+    tcp::acceptor acceptor_;
+    std::thread thread_;
+
+    void accept(asio::yield_context yield) {
+        while (true) {
+            boost::system::error_code ec;
+            tcp::socket socket(io_context_);
+            acceptor_.async_accept(socket, yield[ec]);
+            if (ec) {
+                return;
+            }
+            socket.set_option(tcp::no_delay(true));
+            asio::spawn(io_context_, [this, socket = std::move(socket)] (asio::yield_context yield) mutable {
+                serve(socket, yield);
+            });
+        }
+    }
+
+    void serve(tcp::socket& socket, asio::yield_context yield) {
+        boost::system::error_code ec;
+        asio::steady_timer timer(io_context_);
+        wait(timer, args_.setup_cost, yield[ec]);
+        const char ready = 0;
+        asio::async_write(socket, asio::buffer(&ready, 1), yield[ec]);
+        std::vector<char> buffer(args_.request_size);
+        while (!ec) {
+            asio::async_read(socket, asio::buffer(buffer), yield[ec]);
+            if (ec) {
+                return;
+            }
+            wait(timer, args_.server_latency, yield[ec]);
+            asio::async_write(socket, asio::buffer(buffer), yield[ec]);
+        }
+    }
+};
+
+struct client {
+    asio::io_context io_context;
+    const connection_args args;
+    const tcp::endpoint endpoint;
+    bool stop = false;
+    std::size_t active = 0;
+    std::int64_t completed = 0;
+    std::int64_t connects = 0;
+    std::int64_t errors = 0;
+    benchmarks::latencies latencies;
+
+    client(const connection_args& args, tcp::endpoint endpoint) : args(args), endpoint(endpoint) {}
+
+    void connect(tcp::socket& socket, asio::yield_context yield) {
+        ++connects;
+        socket.async_connect(endpoint, yield);
+        socket.set_option(tcp::no_delay(true));
+        // Reset on close so closed connections don't hold ephemeral ports in TIME_WAIT.
+        socket.set_option(asio::socket_base::linger(true, 0));
+        char ready = 0;
+        asio::async_read(socket, asio::buffer(&ready, 1), yield);
+    }
+
+    void request(tcp::socket& socket, std::vector<char>& buffer, asio::yield_context yield) {
+        asio::async_write(socket, asio::buffer(buffer), yield);
+        asio::async_read(socket, asio::buffer(buffer), yield);
+    }
+
+    template <class Function>
+    void spawn(Function&& function) {
+        ++active;
+        asio::spawn(io_context, [this, function = std::forward<Function>(function)] (asio::yield_context yield) {
+            std::vector<char> buffer(args.request_size);
+            while (!stop) {
+                const auto start = std::chrono::steady_clock::now();
+                try {
+                    function(buffer, yield);
+                    latencies.add(std::chrono::steady_clock::now() - start);
+                } catch (const boost::system::system_error&) {
+                    ++errors;
+                }
+                ++completed;
+            }
+            --active;
+        });
+    }
+
+    void run(benchmark::State& state) {
+        for (auto _ : state) {
+            const auto done = completed;
+            while (completed == done) {
+                io_context.run_one();
+            }
+        }
+        stop = true;
+        while (active > 0) {
+            io_context.run_one();
+        }
+        latencies.report(state);
+        state.counters["connects"] = benchmark::Counter(static_cast<double>(connects), benchmark::Counter::kAvgIterations);
+        state.counters["errors"] = benchmark::Counter(static_cast<double>(errors), benchmark::Counter::kAvgIterations);
+    }
+};
+
+using socket_pool = async::pool<tcp::socket>;
+
+connection_args make_args(benchmark::State& state) {
+    connection_args result;
+    result.request_size = static_cast<std::size_t>(state.range(0));
+    result.server_latency = std::chrono::microseconds(state.range(1));
+    result.setup_cost = std::chrono::microseconds(state.range(2));
+    return result;
+}
+
+constexpr std::size_t concurrency = 8;
+
+void run_pooled(benchmark::State& state, const connection_args& args,
+        time_traits::duration idle_timeout, time_traits::duration lifespan) {
+    const echo_server server(args);
+    client c(args, server.endpoint());
+    socket_pool pool(concurrency, concurrency, idle_timeout, lifespan);
+    for (std::size_t i = 0; i < concurrency; ++i) {
+        c.spawn([&] (std::vector<char>& buffer, asio::yield_context yield) {
+            auto handle = pool.get_auto_waste(c.io_context, yield, std::chrono::seconds(1));
+            if (handle.empty()) {
+                tcp::socket socket(c.io_context);
+                c.connect(socket, yield);
+                handle.reset(std::move(socket));
+            }
+            c.request(*handle, buffer, yield);
+            handle.recycle();
+        });
+    }
+    c.run(state);
+}
+
+void connection_pooled(benchmark::State& state) {
+    run_pooled(state, make_args(state), time_traits::duration::max(), time_traits::duration::max());
+}
+
+void connection_unpooled(benchmark::State& state) {
+    const auto args = make_args(state);
+    const echo_server server(args);
+    client c(args, server.endpoint());
+    for (std::size_t i = 0; i < concurrency; ++i) {
+        c.spawn([&] (std::vector<char>& buffer, asio::yield_context yield) {
+            tcp::socket socket(c.io_context);
+            c.connect(socket, yield);
+            c.request(socket, buffer, yield);
+        });
+    }
+    c.run(state);
+}
+
+void connection_churn(benchmark::State& state) {
+    connection_args args;
+    args.request_size = 64;
+    args.setup_cost = std::chrono::microseconds(state.range(2));
+    const auto idle_timeout = state.range(0) == 0
+        ? time_traits::duration::max() : time_traits::duration(std::chrono::microseconds(state.range(0)));
+    const auto lifespan = state.range(1) == 0
+        ? time_traits::duration::max() : time_traits::duration(std::chrono::microseconds(state.range(1)));
+    run_pooled(state, args, idle_timeout, lifespan);
+}
+
+void connection_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->ArgNames({"request_size", "server_latency_us", "setup_us"});
+    for (const int request_size : {64, 4096}) {
+        for (const int server_latency : {0, 100}) {
+            for (const int setup : {0, 500}) {
+                b->Args({request_size, server_latency, setup});
+            }
+        }
+    }
+}
+
+void churn_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->ArgNames({"idle_timeout_us", "lifespan_us", "setup_us"});
+    for (const int setup : {0, 500}) {
+        b->Args({0, 0, setup});
+        b->Args({100, 0, setup});
+        b->Args({0, 1000, setup});
+        b->Args({0, 10000, setup});
+    }
+}
+
+}
+
+BENCHMARK(connection_pooled)->Apply(connection_benchmarks);
+BENCHMARK(connection_unpooled)->Apply(connection_benchmarks);
+BENCHMARK(connection_churn)->Apply(churn_benchmarks);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,64 @@
+#ifndef YAMAIL_RESOURCE_POOL_BENCHMARKS_LATENCY_HPP
+#define YAMAIL_RESOURCE_POOL_BENCHMARKS_LATENCY_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace benchmarks {
+
+class latencies {
+public:
+    using duration = std::chrono::steady_clock::duration;
+
+    void reserve(std::size_t value) {
+        samples_.reserve(value);
+    }
+
+    void add(duration value) {
+        samples_.push_back(value);
+    }
+
+    void merge(const latencies& other) {
+        samples_.insert(samples_.end(), other.samples_.begin(), other.samples_.end());
+    }
+
+    void clear() {
+        samples_.clear();
+    }
+
+    std::size_t size() const {
+        return samples_.size();
+    }
+
+    void report(benchmark::State& state) {
+        if (samples_.empty()) {
+            return;
+        }
+        std::sort(samples_.begin(), samples_.end());
+        state.counters["p50_ns"] = percentile(0.5);
+        state.counters["p90_ns"] = percentile(0.9);
+        state.counters["p99_ns"] = percentile(0.99);
+        state.counters["p999_ns"] = percentile(0.999);
+        state.counters["max_ns"] = nanoseconds(samples_.back());
+    }
+
+private:
+    std::vector<duration> samples_;
+
+    double percentile(double value) const {
+        const auto index = static_cast<std::size_t>(value * static_cast<double>(samples_.size() - 1));
+        return nanoseconds(samples_[index]);
+    }
+
+    static double nanoseconds(duration value) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(value).count());
+    }
+};
+
+} // namespace benchmarks
+
+#endif // YAMAIL_RESOURCE_POOL_BENCHMARKS_LATENCY_HPP
@@ -0,0 +1,87 @@
+#include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/sync/pool.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using boost::system::error_code;
+
+struct resource {
+    std::int64_t value = 0;
+};
+
+template <class Pool>
+void memory_sync_pool(benchmark::State& state) {
+    const auto capacity = static_cast<std::size_t>(state.range(0));
+    memory_usage usage;
+    for (auto _ : state) {
+        Pool pool(capacity);
+        usage = pool.memory_usage();
+        benchmark::DoNotOptimize(usage);
+    }
+    state.counters["bytes_per_cell"] = static_cast<double>(usage.cells) / static_cast<double>(capacity);
+    state.counters["pool_bytes"] = static_cast<double>(usage.pool);
+    state.counters["total_bytes"] = static_cast<double>(usage.total());
+}
+
+BENCHMARK_TEMPLATE(memory_sync_pool, sync::pool<resource>)->RangeMultiplier(16)->Range(1, 4096);
+BENCHMARK_TEMPLATE(memory_sync_pool, sync::fair_pool<resource>)->RangeMultiplier(16)->Range(1, 4096);
+
+void memory_async_pool(benchmark::State& state) {
+    const auto capacity = static_cast<std::size_t>(state.range(0));
+    memory_usage usage;
+    for (auto _ : state) {
+        async::pool<resource> pool(capacity, capacity);
+        usage = pool.memory_usage();
+        benchmark::DoNotOptimize(usage);
+    }
+    state.counters["bytes_per_cell"] = static_cast<double>(usage.cells) / static_cast<double>(capacity);
+    state.counters["pool_bytes"] = static_cast<double>(usage.pool);
+    state.counters["total_bytes"] = static_cast<double>(usage.total());
+}
+
+BENCHMARK(memory_async_pool)->RangeMultiplier(16)->Range(1, 4096);
+
+// Queues waiters behind single held resource, then serves all of them and measures what stays resident.
+void memory_async_queue(benchmark::State& state) {
+    using pool_t = async::pool<resource>;
+    const auto waiters = static_cast<std::size_t>(state.range(0));
+    memory_usage queued;
+    memory_usage drained;
+    for (auto _ : state) {
+        asio::io_context io;
+        pool_t pool(1, waiters);
+        pool_t::handle held;
+        pool.get_auto_recycle(io, [&] (error_code, pool_t::handle handle) { held = std::move(handle); });
+        io.poll();
+        for (std::size_t i = 0; i < waiters; ++i) {
+            pool.get_auto_recycle(io, [] (error_code, pool_t::handle) {}, std::chrono::hours(1));
+        }
+        queued = pool.memory_usage();
+        held.recycle();
+        io.restart();
+        io.run();
+        drained = pool.memory_usage();
+    }
+    const auto per_waiter = [&] (std::size_t bytes) {
+        return static_cast<double>(bytes) / static_cast<double>(waiters);
+    };
+    state.counters["bytes_per_waiter"] = per_waiter(queued.queue_nodes + queued.handlers);
+    state.counters["node_bytes_per_waiter"] = per_waiter(queued.queue_nodes);
+    state.counters["handler_bytes_per_waiter"] = per_waiter(queued.handlers);
+    state.counters["timer_bytes"] = static_cast<double>(queued.timers);
+    state.counters["resident_bytes_after_drain"] = static_cast<double>(drained.total() - drained.cells - drained.pool);
+}
+
+BENCHMARK(memory_async_queue)->RangeMultiplier(10)->Range(1, 100000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,105 @@
+#include <yamail/resource_pool/async/detail/queue.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/asio/io_context.hpp>
+
+#include <memory>
+#include <random>
+
+namespace {
+
+using namespace yamail::resource_pool;
+
+struct request {
+    void operator ()(const boost::system::error_code&) const {}
+};
+
+struct stub_timer {
+    explicit stub_timer(boost::asio::io_context&) {}
+
+    void expires_at(time_traits::time_point) {}
+
+    template <class Handler>
+    void async_wait(Handler&&) {}
+
+    void cancel() {}
+};
+
+template <class Timer>
+using queue_t = async::detail::queue<request, std::mutex, boost::asio::io_context, Timer>;
+
+constexpr std::size_t poll_period = 1024;
+
+template <class Timer>
+void queue_push_pop(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto distinct_timeouts = state.range(1);
+    boost::asio::io_context io_context;
+    const auto queue = std::make_shared<queue_t<Timer>>(size + 1);
+    std::minstd_rand generator(0);
+    std::uniform_int_distribution<std::int64_t> distribution(0, distinct_timeouts - 1);
+    const auto wait_duration = [&] {
+        return time_traits::duration(std::chrono::hours(1)) + std::chrono::milliseconds(distribution(generator));
+    };
+    for (std::size_t i = 0; i < size; ++i) {
+        queue->push(io_context, wait_duration(), request {});
+    }
+    std::size_t step = 0;
+    for (auto _ : state) {
+        queue->push(io_context, wait_duration(), request {});
+        benchmark::DoNotOptimize(queue->pop());
+        if (++step % poll_period == 0) {
+            io_context.poll();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Timer>
+void queue_push_cancel(benchmark::State& state) {
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    const auto expired_percent = static_cast<std::size_t>(state.range(1));
+    boost::asio::io_context io_context;
+    const auto queue = std::make_shared<queue_t<Timer>>(batch);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            const auto wait_duration = i % 100 < expired_percent
+                ? time_traits::duration(0)
+                : time_traits::duration(std::chrono::hours(1));
+            queue->push(io_context, wait_duration, request {});
+        }
+        io_context.restart();
+        io_context.poll();
+        while (queue->pop()) {}
+    }
+    state.counters["expired"] = benchmark::Counter(static_cast<double>(queue->expired()),
+        benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void push_pop_benchmarks(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"size", "distinct_timeouts"});
+    for (const int size : {0, 10, 100, 1000, 10000}) {
+        for (const int distinct : {1, 1000}) {
+            b->Args({size, distinct});
+        }
+    }
+}
+
+void push_cancel_benchmarks(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"batch", "expired_percent"});
+    for (const int batch : {10, 100, 1000}) {
+        for (const int expired : {0, 50, 100}) {
+            b->Args({batch, expired});
+        }
+    }
+}
+
+}
+
+BENCHMARK_TEMPLATE(queue_push_pop, stub_timer)->Apply(push_pop_benchmarks);
+BENCHMARK_TEMPLATE(queue_push_pop, time_traits::timer)->Apply(push_pop_benchmarks);
+BENCHMARK_TEMPLATE(queue_push_cancel, time_traits::timer)->Apply(push_cancel_benchmarks);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+#include <yamail/resource_pool/detail/storage.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using namespace yamail::resource_pool;
+
+struct resource {
+    std::int64_t value = 0;
+};
+
+using storage_t = detail::storage<resource>;
+using cell_iterator = storage_t::cell_iterator;
+
+void fill(storage_t& storage, std::size_t count) {
+    std::vector<cell_iterator> cells;
+    cells.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto cell = storage.lease();
+        if (!cell) {
+            break;
+        }
+        (*cell)->value = resource {};
+        (*cell)->reset_time = time_traits::now();
+        cells.push_back(*cell);
+    }
+    for (const auto cell : cells) {
+        storage.recycle(cell);
+    }
+}
+
+std::vector<cell_iterator> lease_many(storage_t& storage, std::size_t count) {
+    std::vector<cell_iterator> result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (const auto cell = storage.lease()) {
+            result.push_back(*cell);
+        }
+    }
+    return result;
+}
+
+void storage_lease_recycle(benchmark::State& state) {
+    const auto capacity = static_cast<std::size_t>(state.range(0));
+    const auto used = static_cast<std::size_t>(state.range(1));
+    storage_t storage(capacity, time_traits::duration::max(), time_traits::duration::max());
+    fill(storage, capacity);
+    const auto held = lease_many(storage, used);
+    for (auto _ : state) {
+        const auto cell = storage.lease();
+        benchmark::DoNotOptimize(++(*cell)->value->value);
+        storage.recycle(*cell);
+    }
+    for (const auto cell : held) {
+        storage.recycle(cell);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void storage_lease_waste(benchmark::State& state) {
+    const auto capacity = static_cast<std::size_t>(state.range(0));
+    storage_t storage(capacity, time_traits::duration::max(), time_traits::duration::max());
+    for (auto _ : state) {
+        const auto cell = storage.lease();
+        (*cell)->value = resource {};
+        benchmark::DoNotOptimize((*cell)->value->value);
+        storage.waste(*cell);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void storage_lease_expired(benchmark::State& state) {
+    const auto capacity = static_cast<std::size_t>(state.range(0));
+    const auto expired_percent = state.range(1);
+    storage_t storage(capacity, time_traits::duration::max(), time_traits::duration::max());
+    std::int64_t step = 0;
+    for (auto _ : state) {
+        const auto cell = storage.lease();
+        if (!(*cell)->value) {
+            (*cell)->value = resource {};
+            (*cell)->reset_time = time_traits::now();
+        }
+        benchmark::DoNotOptimize(++(*cell)->value->value);
+        storage.recycle(*cell);
+        if (step++ % 100 < expired_percent) {
+            (*cell)->drop_time = time_traits::time_point::min();
+        }
+    }
+    state.counters["idle_timeout_expirations"] = benchmark::Counter(
+        static_cast<double>(storage.counters().idle_timeout_expirations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void storage_invalidate(benchmark::State& state) {
+    const auto capacity = static_cast<std::size_t>(state.range(0));
+    storage_t storage(capacity, time_traits::duration::max(), time_traits::duration::max());
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill(storage, capacity);
+        state.ResumeTiming();
+        storage.invalidate();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void used_benchmarks(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"capacity", "used"});
+    for (const int capacity : {1, 10, 100, 1000, 10000}) {
+        b->Args({capacity, 0});
+        if (capacity > 1) {
+            b->Args({capacity, capacity / 2});
+            b->Args({capacity, capacity - 1});
+        }
+    }
+}
+
+void expired_benchmarks(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"capacity", "expired_percent"});
+    for (const int capacity : {1, 100, 10000}) {
+        for (const int expired : {0, 10, 50, 100}) {
+            b->Args({capacity, expired});
+        }
+    }
+}
+
+}
+
+BENCHMARK(storage_lease_recycle)->Apply(used_benchmarks);
+BENCHMARK(storage_lease_waste)->Arg(1)->Arg(100)->Arg(10000);
+BENCHMARK(storage_lease_expired)->Apply(expired_benchmarks);
+BENCHMARK(storage_invalidate)->Arg(1)->Arg(100)->Arg(10000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,206 @@
+#include "latency.hpp"
+
+#include <yamail/resource_pool/sync/pool.hpp>
+#include <yamail/resource_pool/detail/spin.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using namespace yamail::resource_pool;
+
+struct resource {
+    std::int64_t value = 0;
+};
+
+enum class strategy {
+    waste,
+    recycle,
+};
+
+template <class Pool>
+struct shared_state {
+    std::unique_ptr<Pool> pool;
+    std::vector<benchmarks::latencies> latencies;
+};
+
+void hold_for(std::chrono::nanoseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+        detail::cpu_relax();
+    }
+}
+
+template <class Pool, class MakePool>
+void get_auto(benchmark::State& state, MakePool&& make_pool, std::chrono::nanoseconds hold,
+        strategy use_strategy, time_traits::duration timeout) {
+    static shared_state<Pool> shared;
+    if (state.thread_index() == 0) {
+        shared.pool = make_pool();
+        shared.latencies.assign(static_cast<std::size_t>(state.threads()), benchmarks::latencies());
+        for (auto& latencies : shared.latencies) {
+            latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+        }
+    }
+    std::int64_t acquired = 0;
+    std::int64_t timeouts = 0;
+    for (auto _ : state) {
+        auto& latencies = shared.latencies[static_cast<std::size_t>(state.thread_index())];
+        const auto start = std::chrono::steady_clock::now();
+        auto result = use_strategy == strategy::waste
+            ? shared.pool->get_auto_waste(timeout)
+            : shared.pool->get_auto_recycle(timeout);
+        latencies.add(std::chrono::steady_clock::now() - start);
+        if (result.first == error::get_resource_timeout) {
+            ++timeouts;
+            continue;
+        }
+        if (result.first) {
+            state.SkipWithError(result.first.message().c_str());
+            break;
+        }
+        ++acquired;
+        auto& handle = result.second;
+        if (handle.empty()) {
+            handle.reset(resource {});
+        }
+        benchmark::DoNotOptimize(++handle->value);
+        if (hold.count() > 0) {
+            hold_for(hold);
+        }
+    }
+    state.counters["acquired"] = benchmark::Counter(static_cast<double>(acquired), benchmark::Counter::kIsRate);
+    state.counters["timeouts"] = benchmark::Counter(static_cast<double>(timeouts), benchmark::Counter::kIsRate);
+    if (state.thread_index() == 0) {
+        benchmarks::latencies merged;
+        for (const auto& latencies : shared.latencies) {
+            merged.merge(latencies);
+        }
+        merged.report(state);
+        shared.pool.reset();
+    }
+}
+
+template <class Pool>
+void get_auto_recycle_latency(benchmark::State& state) {
+    const auto resources = static_cast<std::size_t>(state.range(0));
+    get_auto<Pool>(state, [&] { return std::make_unique<Pool>(resources); }, std::chrono::nanoseconds(0),
+        strategy::recycle, std::chrono::seconds(1));
+}
+
+void get_auto_recycle_short_hold(benchmark::State& state) {
+    using pool_t = sync::pool<resource>;
+    const auto resources = static_cast<std::size_t>(state.range(0));
+    const sync::adaptive_wait wait {static_cast<std::size_t>(state.range(1)), 64};
+    const auto make_pool = [&] {
+        return std::make_unique<pool_t>(resources, time_traits::duration::max(), time_traits::duration::max(), wait);
+    };
+    get_auto<pool_t>(state, make_pool, std::chrono::nanoseconds(state.range(2)), strategy::recycle,
+        std::chrono::seconds(1));
+}
+
+template <class Pool>
+void get_auto_scaling(benchmark::State& state) {
+    const auto resources = static_cast<std::size_t>(state.range(0));
+    get_auto<Pool>(state, [&] { return std::make_unique<Pool>(resources); }, std::chrono::nanoseconds(state.range(1)),
+        strategy::recycle, std::chrono::seconds(1));
+}
+
+void get_auto_strategy(benchmark::State& state) {
+    using pool_t = sync::pool<resource>;
+    const auto resources = static_cast<std::size_t>(state.range(0));
+    get_auto<pool_t>(state, [&] { return std::make_unique<pool_t>(resources); }, std::chrono::nanoseconds(0),
+        static_cast<strategy>(state.range(1)), std::chrono::seconds(1));
+}
+
+void get_auto_timeout(benchmark::State& state) {
+    using pool_t = sync::pool<resource>;
+    const auto resources = static_cast<std::size_t>(state.range(0));
+    get_auto<pool_t>(state, [&] { return std::make_unique<pool_t>(resources); }, std::chrono::nanoseconds(state.range(1)),
+        strategy::recycle, std::chrono::microseconds(state.range(2)));
+}
+
+template <class Pool>
+void get_auto_waste_uncontended(benchmark::State& state) {
+    Pool pool(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto result = pool.get_auto_waste();
+        auto& handle = result.second;
+        if (handle.empty()) {
+            handle.reset(resource {});
+        }
+        benchmark::DoNotOptimize(++handle->value);
+        handle.recycle();
+    }
+}
+
+void contended_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->Arg(1)->Arg(4);
+    for (const int threads : {2, 4, 8, 16}) {
+        b->Threads(threads);
+    }
+}
+
+void short_hold_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->ArgNames({"resources", "spins", "hold_ns"});
+    for (const int resources : {1, 4}) {
+        for (const int spins : {0, 16, 256}) {
+            for (const int hold : {500, 2000}) {
+                b->Args({resources, spins, hold});
+            }
+        }
+    }
+    for (const int threads : {2, 4, 8, 16, 32}) {
+        b->Threads(threads);
+    }
+}
+
+void scaling_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->ArgNames({"resources", "hold_ns"});
+    for (const int resources : {1, 10, 100, 1000}) {
+        for (const int hold : {0, 1000, 10000}) {
+            b->Args({resources, hold});
+        }
+    }
+    for (const int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        b->Threads(threads);
+    }
+}
+
+void strategy_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->ArgNames({"resources", "recycle"});
+    for (const int resources : {1, 100}) {
+        b->Args({resources, static_cast<int>(strategy::waste)});
+        b->Args({resources, static_cast<int>(strategy::recycle)});
+    }
+    for (const int threads : {1, 8, 64}) {
+        b->Threads(threads);
+    }
+}
+
+void timeout_benchmarks(benchmark::internal::Benchmark* b) {
+    b->UseRealTime()->ArgNames({"resources", "hold_ns", "timeout_us"});
+    for (const int timeout : {0, 10, 100, 1000}) {
+        b->Args({1, 10000, timeout});
+    }
+    for (const int threads : {2, 8, 32, 64}) {
+        b->Threads(threads);
+    }
+}
+
+}
+
+BENCHMARK_TEMPLATE(get_auto_recycle_latency, sync::pool<resource>)->Apply(contended_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_recycle_latency, sync::fair_pool<resource>)->Apply(contended_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_waste_uncontended, sync::pool<resource>)->Arg(1)->Arg(100);
+BENCHMARK_TEMPLATE(get_auto_waste_uncontended, sync::fair_pool<resource>)->Arg(1)->Arg(100);
+BENCHMARK(get_auto_recycle_short_hold)->Apply(short_hold_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_scaling, sync::pool<resource>)->Apply(scaling_benchmarks);
+BENCHMARK_TEMPLATE(get_auto_scaling, sync::fair_pool<resource>)->Apply(scaling_benchmarks);
+BENCHMARK(get_auto_strategy)->Apply(strategy_benchmarks);
+BENCHMARK(get_auto_timeout)->Apply(timeout_benchmarks);
+
+BENCHMARK_MAIN();
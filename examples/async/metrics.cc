@@ -0,0 +1,80 @@
+#include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/openmetrics.hpp>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+
+namespace asio = boost::asio;
+namespace openmetrics = yamail::resource_pool::openmetrics;
+
+using int_pool = yamail::resource_pool::async::pool<int>;
+using time_traits = yamail::resource_pool::time_traits;
+
+struct session : std::enable_shared_from_this<session> {
+    asio::ip::tcp::socket socket;
+    std::array<char, 1024> request;
+    std::array<char, 64 * 1024> body;
+    std::array<char, 128> header;
+    std::array<asio::const_buffer, 2> response;
+
+    explicit session(asio::ip::tcp::socket socket) : socket(std::move(socket)) {}
+
+    void start(const int_pool& pool) {
+        const auto metrics = openmetrics::write(body.data(), body.size(), openmetrics::named("ints", pool));
+        const auto header_size = std::snprintf(header.data(), header.size(),
+            "HTTP/1.0 200 OK\r\n"
+            "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+            "Content-Length: %zu\r\n\r\n", metrics.size());
+        response = {asio::buffer(header.data(), static_cast<std::size_t>(header_size)), asio::buffer(metrics)};
+        socket.async_read_some(asio::buffer(request), [self = shared_from_this()] (auto ec, std::size_t) {
+            if (ec) {
+                return;
+            }
+            asio::async_write(self->socket, self->response, [self] (auto, std::size_t) {});
+        });
+    }
+};
+
+void accept(asio::ip::tcp::acceptor& acceptor, const int_pool& pool) {
+    acceptor.async_accept([&] (boost::system::error_code ec, asio::ip::tcp::socket socket) {
+        if (ec) {
+            std::cerr << "accept error: " << ec.message() << std::endl;
+            return;
+        }
+        std::make_shared<session>(std::move(socket))->start(pool);
+        accept(acceptor, pool);
+    });
+}
+
+void use(asio::io_context& io, asio::steady_timer& timer, int_pool& pool) {
+    pool.get_auto_recycle(io, [&] (boost::system::error_code ec, int_pool::handle handle) {
+        if (!ec && handle.empty()) {
+            handle.reset(42);
+        }
+        timer.expires_after(std::chrono::milliseconds(100));
+        timer.async_wait([&] (boost::system::error_code ec) {
+            if (!ec) {
+                use(io, timer, pool);
+            }
+        });
+    }, time_traits::duration::max());
+}
+
+int main(int argc, char** argv) {
+    const unsigned short port = argc > 1 ? static_cast<unsigned short>(std::stoul(argv[1])) : 9100;
+    asio::io_context io;
+    int_pool pool(4, 16);
+    asio::ip::tcp::acceptor acceptor(io, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port));
+    std::cout << "serving metrics on http://127.0.0.1:" << acceptor.local_endpoint().port() << "/metrics" << std::endl;
+    accept(acceptor, pool);
+    asio::steady_timer timer(io);
+    use(io, timer, pool);
+    io.run();
+    return 0;
+}
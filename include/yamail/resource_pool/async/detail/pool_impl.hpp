@@ -1,10 +1,16 @@
 #ifndef YAMAIL_RESOURCE_POOL_ASYNC_DETAIL_POOL_IMPL_HPP
 #define YAMAIL_RESOURCE_POOL_ASYNC_DETAIL_POOL_IMPL_HPP
 
+#include <yamail/resource_pool/counters.hpp>
 #include <yamail/resource_pool/error.hpp>
+#include <yamail/resource_pool/histogram.hpp>
+#include <yamail/resource_pool/instrumented_mutex.hpp>
+#include <yamail/resource_pool/memory_usage.hpp>
+#include <yamail/resource_pool/observer.hpp>
 #include <yamail/resource_pool/detail/idle.hpp>
 #include <yamail/resource_pool/detail/storage.hpp>
 #include <yamail/resource_pool/detail/pool_returns.hpp>
+#include <yamail/resource_pool/async/handoff.hpp>
 #include <yamail/resource_pool/async/detail/queue.hpp>
 
 #include <boost/asio/dispatch.hpp>
@@ -23,6 +29,11 @@ struct stats {
     std::size_t available;
     std::size_t used;
     std::size_t queue_size;
+    pool_counters counters {};
+    // Pool mutex, or the single mutex of pool locked queue.
+    mutex_stats mutex {};
+    // Own mutex of queue, zero for pool locked queue.
+    mutex_stats queue_mutex {};
 };
 
 namespace detail {
@@ -69,6 +80,7 @@ on_list_iterator_handler(boost::system::error_code, ListIterator, Handler&&)
 template <class T>
 struct base_list_iterator_handler_impl {
     virtual void operator ()(boost::system::error_code ec, cell_iterator<T> iterator) = 0;
+    virtual std::size_t memory_usage() const noexcept = 0;
     virtual ~base_list_iterator_handler_impl() = default;
 };
 
@@ -88,6 +100,10 @@ public:
         handler(ec, iterator);
     }
 
+    std::size_t memory_usage() const noexcept final {
+        return sizeof(*this);
+    }
+
 private:
     Handler handler;
 };
@@ -122,6 +138,10 @@ public:
         return executor;
     }
 
+    std::size_t memory_usage() const noexcept {
+        return impl ? impl->memory_usage() : 0;
+    }
+
 private:
     asio::executor executor;
     std::unique_ptr<base_list_iterator_handler_impl<T>> impl;
@@ -186,15 +206,22 @@ template <class ListIterator, class Handler>
 on_serve_queued_handler(ListIterator, Handler&&)
     -> on_serve_queued_handler<cell_value<ListIterator>, std::decay_t<Handler>>;
 
-template <class Value, class Mutex, class IoContext, class Queue>
+template <class Value, class Mutex, class IoContext, class Queue, class Handoff = fifo_handoff,
+          class Storage = resource_pool::detail::storage<Value>, class Observer = null_observer>
 class pool_impl : public pool_returns<Value> {
 public:
     using value_type = Value;
     using io_context_t = IoContext;
     using idle = resource_pool::detail::idle<value_type>;
-    using storage_type = resource_pool::detail::storage<value_type>;
+    using storage_type = Storage;
     using list_iterator = typename storage_type::cell_iterator;
     using queue_type = Queue;
+    using handoff_type = Handoff;
+    using observer_type = Observer;
+    using time_traits_type = typename storage_type::time_traits_type;
+
+    // Queue operations are guarded by pool lock instead of separate queue mutex.
+    static constexpr bool queue_locked_by_pool = is_locked_by_pool<queue_type>::value;
 
     pool_impl(std::size_t capacity,
               std::size_t queue_capacity,
@@ -237,6 +264,11 @@ public:
     std::size_t available() const noexcept;
     std::size_t used() const noexcept;
     async::stats stats() const noexcept;
+    latency_stats latency() const noexcept { return _latency.snapshot(); }
+    resource_pool::memory_usage memory_usage() const;
+
+    template <class S = storage_type>
+    auto node_stats() const -> decltype(std::declval<const S&>().node_stats());
 
     const queue_type& queue() const noexcept { return *_callbacks; }
 
@@ -244,9 +276,16 @@ public:
     void get(io_context_t& io_context, Handler&& handler, time_traits::duration wait_duration = time_traits::duration(0));
     void recycle(list_iterator res_it) final;
     void waste(list_iterator res_it) final;
+    time_traits::time_point now() const final { return time_traits_type::now(); }
     void disable();
     void invalidate();
 
+    template <class Function>
+    void for_each_lease(Function&& function) const {
+        const lock_guard lock(mutex());
+        storage_.for_each_used(function);
+    }
+
     static std::size_t assert_capacity(std::size_t value);
 
 private:
@@ -254,105 +293,144 @@ private:
     using unique_lock = std::unique_lock<mutex_t>;
     using lock_guard = std::lock_guard<mutex_t>;
 
-    mutable mutex_t _mutex;
+    // Pool locked queue owns the single mutex.
+    struct no_mutex {};
+
+    mutable std::conditional_t<queue_locked_by_pool, no_mutex, mutex_t> _mutex;
     storage_type storage_;
     const std::size_t _capacity;
     std::shared_ptr<queue_type> _callbacks;
     bool _disabled = false;
+    resource_pool::detail::pool_latency _latency;
+    resource_pool::detail::error_counters _errors;
+
+    mutex_t& mutex() const noexcept;
+    void record_handoff(time_traits::time_point now, time_traits::time_point enqueued_at);
+
+    template <class Q2>
+    static auto queue_lock_stats(const Q2& queue, int) noexcept -> decltype(queue.lock_stats()) {
+        return queue.lock_stats();
+    }
+
+    template <class Q2>
+    static mutex_stats queue_lock_stats(const Q2&, long) noexcept { return {}; }
+
+    template <class Q2>
+    static auto queue_memory_usage(const Q2& queue, int) -> decltype(queue.memory_usage()) {
+        return queue.memory_usage();
+    }
+
+    template <class Q2>
+    static resource_pool::memory_usage queue_memory_usage(const Q2&, long) { return {}; }
+
+    // Completes request of disabled pool or with leased resource and releases the lock. Returns false keeping the
+    // lock and the handler untouched otherwise.
+    template <class Handler>
+    bool serve_without_queue(unique_lock& lock, io_context_t& io_context, time_traits::time_point start,
+        Handler&& handler);
 };
 
-template <class V, class M, class I, class Q>
-std::size_t pool_impl<V, M, I, Q>::size() const noexcept {
-    const auto stats = [&] {
-        const lock_guard lock(_mutex);
-        return storage_.stats();
-    } ();
+template <class V, class M, class I, class Q, class H, class S, class O>
+std::size_t pool_impl<V, M, I, Q, H, S, O>::size() const noexcept {
+    const auto stats = storage_.stats();
     return stats.available + stats.used;
 }
 
-template <class V, class M, class I, class Q>
-std::size_t pool_impl<V, M, I, Q>::available() const noexcept {
-    const lock_guard lock(_mutex);
+template <class V, class M, class I, class Q, class H, class S, class O>
+std::size_t pool_impl<V, M, I, Q, H, S, O>::available() const noexcept {
     return storage_.stats().available;
 }
 
-template <class V, class M, class I, class Q>
-std::size_t pool_impl<V, M, I, Q>::used() const noexcept {
-    const lock_guard lock(_mutex);
+template <class V, class M, class I, class Q, class H, class S, class O>
+std::size_t pool_impl<V, M, I, Q, H, S, O>::used() const noexcept {
     return storage_.stats().used;
 }
 
-template <class V, class M, class I, class Q>
-async::stats pool_impl<V, M, I, Q>::stats() const noexcept {
-    const auto stats = [&] {
-        const lock_guard lock(_mutex);
-        return storage_.stats();
-    } ();
+template <class V, class M, class I, class Q, class H, class S, class O>
+async::stats pool_impl<V, M, I, Q, H, S, O>::stats() const noexcept {
+    const auto stats = storage_.stats();
+    const auto counters = storage_.counters();
     async::stats result;
     result.size = stats.available + stats.used;
     result.available = stats.available;
     result.used = stats.used;
     result.queue_size = _callbacks->size();
+    result.counters = _errors.make_pool_counters(counters);
+    result.counters.get_resource_timeouts += _callbacks->expired();
+    result.mutex = resource_pool::detail::get_mutex_stats(mutex());
+    result.queue_mutex = queue_lock_stats(*_callbacks, 0);
     return result;
 }
 
-template <class V, class M, class I, class Q>
-void pool_impl<V, M, I, Q>::recycle(list_iterator res_it) {
-    unique_lock lock(_mutex);
-    auto queued = _callbacks->pop();
+template <class V, class M, class I, class Q, class H, class S, class O>
+resource_pool::memory_usage pool_impl<V, M, I, Q, H, S, O>::memory_usage() const {
+    auto result = queue_memory_usage(*_callbacks, 0);
+    result.pool = sizeof(*this) + sizeof(queue_type);
+    const lock_guard lock(mutex());
+    result.cells = storage_.memory_usage();
+    return result;
+}
+
+template <class V, class M, class I, class Q, class H, class S, class O>
+template <class S2>
+auto pool_impl<V, M, I, Q, H, S, O>::node_stats() const -> decltype(std::declval<const S2&>().node_stats()) {
+    return storage_.node_stats();
+}
+
+template <class V, class M, class I, class Q, class H, class S, class O>
+void pool_impl<V, M, I, Q, H, S, O>::recycle(list_iterator res_it) {
+    const auto now = time_traits_type::now();
+    const auto hold = now - res_it->lease_time;
+    _latency.hold.record(hold);
+    observer_type::recycle(hold);
+    unique_lock lock(mutex());
+    auto queued = handoff_type::pop(*_callbacks);
     if (!queued) {
         storage_.recycle(res_it);
         return;
     }
-    const auto valid = storage_.is_valid(res_it);
+    const auto valid = storage_.validate(res_it);
+    res_it->lease_time = now;
     lock.unlock();
     if (!valid) {
         res_it->value.reset();
     }
+    record_handoff(now, queued->enqueued_at);
     asio::post(queued->io_context, on_serve_queued_handler(res_it, std::move(queued->request)));
 }
 
-template <class V, class M, class I, class Q>
-void pool_impl<V, M, I, Q>::waste(list_iterator res_it) {
-    unique_lock lock(_mutex);
-    auto queued = _callbacks->pop();
+template <class V, class M, class I, class Q, class H, class S, class O>
+void pool_impl<V, M, I, Q, H, S, O>::waste(list_iterator res_it) {
+    const auto now = time_traits_type::now();
+    const auto hold = now - res_it->lease_time;
+    _latency.hold.record(hold);
+    observer_type::waste(hold);
+    unique_lock lock(mutex());
+    auto queued = handoff_type::pop(*_callbacks);
     if (!queued) {
         storage_.waste(res_it);
         return;
     }
+    res_it->lease_time = now;
     lock.unlock();
     res_it->value.reset();
+    record_handoff(now, queued->enqueued_at);
     asio::post(queued->io_context, on_serve_queued_handler(res_it, std::move(queued->request)));
 }
 
-template <class V, class M, class I, class Q>
+template <class V, class M, class I, class Q, class H, class S, class O>
 template <class Handler>
-void pool_impl<V, M, I, Q>::get(io_context_t& io_context, Handler&& handler, time_traits::duration wait_duration) {
+void pool_impl<V, M, I, Q, H, S, O>::get(io_context_t& io_context, Handler&& handler, time_traits::duration wait_duration) {
     static_assert(std::is_invocable_v<std::decay_t<Handler>, boost::system::error_code, list_iterator>);
 
-    unique_lock lock(_mutex);
-    if (_disabled) {
-        lock.unlock();
-        asio::dispatch(io_context,
-            on_list_iterator_handler(
-                make_error_code(error::disabled),
-                list_iterator(),
-                std::forward<Handler>(handler)
-            ));
+    const auto start = time_traits_type::now();
+    unique_lock lock(mutex());
+    if (serve_without_queue(lock, io_context, start, std::forward<Handler>(handler))) {
         return;
     }
-    if (const auto cell = storage_.lease()) {
-        lock.unlock();
-        asio::post(io_context,
-            on_list_iterator_handler(
-                boost::system::error_code(),
-                *cell,
-                std::forward<Handler>(handler)
-            ));
-        return;
-    }
-    lock.unlock();
     if (wait_duration.count() == 0) {
+        lock.unlock();
+        _errors.count(error::get_resource_timeout);
         asio::post(io_context,
             on_list_iterator_handler(
                 make_error_code(error::get_resource_timeout),
@@ -361,11 +439,26 @@ void pool_impl<V, M, I, Q>::get(io_context_t& io_context, Handler&& handler, tim
             ));
         return;
     }
+    lock.unlock();
     list_iterator_handler<value_type> wrapped(std::forward<Handler>(handler));
-    const bool pushed = _callbacks->push(io_context, wait_duration, std::move(wrapped));
+    bool pushed = false;
+    if constexpr (queue_locked_by_pool) {
+        // Handler is type-erased without the lock, so pool could be disabled or resource returned meanwhile.
+        lock.lock();
+        if (serve_without_queue(lock, io_context, start, std::move(wrapped))) {
+            return;
+        }
+        pushed = _callbacks->push(io_context, wait_duration, std::move(wrapped));
+        lock.unlock();
+    } else {
+        pushed = _callbacks->push(io_context, wait_duration, std::move(wrapped));
+    }
     if (pushed) {
+        observer_type::enqueue();
         return;
     }
+    _errors.count(error::request_queue_overflow);
+    observer_type::overflow();
     asio::post(io_context,
         on_error_handler(
             make_error_code(error::request_queue_overflow),
@@ -373,15 +466,47 @@ void pool_impl<V, M, I, Q>::get(io_context_t& io_context, Handler&& handler, tim
         ));
 }
 
-template <class V, class M, class I, class Q>
-void pool_impl<V, M, I, Q>::disable() {
-    const lock_guard lock(_mutex);
+template <class V, class M, class I, class Q, class H, class S, class O>
+template <class Handler>
+bool pool_impl<V, M, I, Q, H, S, O>::serve_without_queue(unique_lock& lock, io_context_t& io_context,
+        time_traits::time_point start, Handler&& handler) {
+    if (_disabled) {
+        lock.unlock();
+        _errors.count(error::disabled);
+        asio::dispatch(io_context,
+            on_list_iterator_handler(
+                make_error_code(error::disabled),
+                list_iterator(),
+                std::forward<Handler>(handler)
+            ));
+        return true;
+    }
+    if (const auto cell = storage_.lease()) {
+        lock.unlock();
+        const auto elapsed = (*cell)->lease_time - start;
+        _latency.acquire.record(elapsed);
+        observer_type::lease(elapsed);
+        asio::post(io_context,
+            on_list_iterator_handler(
+                boost::system::error_code(),
+                *cell,
+                std::forward<Handler>(handler)
+            ));
+        return true;
+    }
+    return false;
+}
+
+template <class V, class M, class I, class Q, class H, class S, class O>
+void pool_impl<V, M, I, Q, H, S, O>::disable() {
+    const lock_guard lock(mutex());
     _disabled = true;
     while (true) {
         auto queued = _callbacks->pop();
         if (!queued) {
             break;
         }
+        _errors.count(error::disabled);
         asio::dispatch(queued->io_context,
             on_error_handler(
                 make_error_code(error::disabled),
@@ -390,14 +515,33 @@ void pool_impl<V, M, I, Q>::disable() {
     }
 }
 
-template <class V, class M, class I, class Q>
-void pool_impl<V, M, I, Q>::invalidate() {
-    const lock_guard lock(_mutex);
+template <class V, class M, class I, class Q, class H, class S, class O>
+void pool_impl<V, M, I, Q, H, S, O>::invalidate() {
+    const lock_guard lock(mutex());
     storage_.invalidate();
 }
 
-template <class V, class M, class I, class Q>
-std::size_t pool_impl<V, M, I, Q>::assert_capacity(std::size_t value) {
+template <class V, class M, class I, class Q, class H, class S, class O>
+typename pool_impl<V, M, I, Q, H, S, O>::mutex_t& pool_impl<V, M, I, Q, H, S, O>::mutex() const noexcept {
+    if constexpr (queue_locked_by_pool) {
+        static_assert(std::is_same_v<typename queue_type::mutex_t, mutex_t>, "Queue and pool mutex types differ");
+        return _callbacks->mutex();
+    } else {
+        return _mutex;
+    }
+}
+
+template <class V, class M, class I, class Q, class H, class S, class O>
+void pool_impl<V, M, I, Q, H, S, O>::record_handoff(time_traits::time_point now, time_traits::time_point enqueued_at) {
+    const auto wait = now - enqueued_at;
+    _latency.wait.record(wait);
+    _latency.acquire.record(wait);
+    observer_type::dequeue(wait);
+    observer_type::lease(wait);
+}
+
+template <class V, class M, class I, class Q, class H, class S, class O>
+std::size_t pool_impl<V, M, I, Q, H, S, O>::assert_capacity(std::size_t value) {
     if (value == 0) {
         throw error::zero_pool_capacity();
     }
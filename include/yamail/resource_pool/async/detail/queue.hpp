@@ -2,16 +2,24 @@
 #define YAMAIL_RESOURCE_POOL_ASYNC_DETAIL_QUEUE_HPP
 
 #include <yamail/resource_pool/error.hpp>
+#include <yamail/resource_pool/instrumented_mutex.hpp>
+#include <yamail/resource_pool/memory_usage.hpp>
+#include <yamail/resource_pool/observer.hpp>
 #include <yamail/resource_pool/time_traits.hpp>
+#include <yamail/resource_pool/detail/relaxed_value.hpp>
 
 #include <boost/asio/executor.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/intrusive/list.hpp>
+#include <boost/intrusive/set.hpp>
+#include <boost/optional.hpp>
 
 #include <algorithm>
-#include <list>
-#include <map>
+#include <memory>
 #include <mutex>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace yamail {
 namespace resource_pool {
@@ -55,20 +63,42 @@ public:
 template <class Handler>
 expired_handler(Handler&&) -> expired_handler<std::decay_t<Handler>>;
 
+template <class Value>
+auto handler_memory_usage(const Value& request, int) noexcept -> decltype(request.memory_usage()) {
+    return request.memory_usage();
+}
+
+template <class Value>
+std::size_t handler_memory_usage(const Value&, long) noexcept { return 0; }
+
 template <class Value, class IoContext>
 struct queued_value {
     Value request;
     IoContext& io_context;
+    time_traits::time_point enqueued_at {};
 };
 
-template <class Value, class Mutex, class IoContext, class Timer>
-class queue : public std::enable_shared_from_this<queue<Value, Mutex, IoContext, Timer>> {
+// Push, pop and pop_preferred lock queue mutex.
+struct own_lock {};
+
+// Caller holds queue mutex around push, pop and pop_preferred, so pool can guard its storage and queue with single
+// lock. Expiration, timer and memory_usage still lock the mutex.
+struct pool_lock {};
+
+template <class Value, class Mutex, class IoContext, class Timer, class Observer = null_observer,
+          class TimeTraits = time_traits, class Locking = own_lock>
+class queue : public std::enable_shared_from_this<queue<Value, Mutex, IoContext, Timer, Observer, TimeTraits, Locking>> {
 public:
     using value_type = Value;
+    using observer_type = Observer;
+    using time_traits_type = TimeTraits;
     using io_context_t = IoContext;
     using timer_t = Timer;
+    using mutex_t = Mutex;
     using queued_value_t = queued_value<value_type, io_context_t>;
 
+    static constexpr bool locked_by_pool = std::is_same_v<Locking, pool_lock>;
+
     queue(std::size_t capacity) : _capacity(capacity) {}
 
     queue(const queue&) = delete;
@@ -78,118 +108,248 @@ public:
     std::size_t capacity() const noexcept { return _capacity; }
     std::size_t size() const noexcept;
     bool empty() const noexcept;
+    std::uint64_t expired() const noexcept;
+    mutex_stats lock_stats() const noexcept;
+    mutex_t& mutex() const noexcept { return _mutex; }
+    resource_pool::memory_usage memory_usage() const;
     const timer_t& timer(io_context_t& io_context);
 
     bool push(io_context_t& io_context, time_traits::duration wait_duration, value_type&& request);
     boost::optional<queued_value_t> pop();
+    template <class Predicate>
+    boost::optional<queued_value_t> pop_preferred(Predicate&& predicate, std::size_t window);
 
 private:
-    using mutex_t = Mutex;
     using lock_guard = std::lock_guard<mutex_t>;
 
-    struct expiring_request {
-        using list = std::list<expiring_request>;
-        using list_it = typename list::iterator;
-        using multimap = std::multimap<time_traits::time_point, expiring_request*>;
-        using multimap_it = typename multimap::iterator;
+    struct no_lock {
+        explicit no_lock(mutex_t&) noexcept {}
+    };
+
+    using operation_lock = std::conditional_t<locked_by_pool, no_lock, lock_guard>;
 
-        io_context_t* io_context;
+    // Preallocated node linked either into free or ordered list and into expiration set while queued.
+    struct expiring_request : boost::intrusive::list_base_hook<>, boost::intrusive::set_base_hook<> {
+        io_context_t* io_context = nullptr;
         queue::value_type request;
-        list_it order_it;
-        multimap_it expires_at_it;
+        time_traits::time_point enqueued_at;
+        time_traits::time_point expires_at;
+        std::size_t bypassed = 0;
+    };
+
+    struct expires_at_less {
+        bool operator ()(const expiring_request& lhs, const expiring_request& rhs) const {
+            return lhs.expires_at < rhs.expires_at;
+        }
 
-        expiring_request() = default;
+        bool operator ()(time_traits::time_point lhs, const expiring_request& rhs) const {
+            return lhs < rhs.expires_at;
+        }
+
+        bool operator ()(const expiring_request& lhs, time_traits::time_point rhs) const {
+            return lhs.expires_at < rhs;
+        }
     };
 
-    using request_multimap_value = typename expiring_request::multimap::value_type;
+    using requests_list = boost::intrusive::list<expiring_request>;
+    using list_it = typename requests_list::iterator;
+    using requests_multiset = boost::intrusive::multiset<expiring_request,
+        boost::intrusive::compare<expires_at_less>>;
     using timers_map = typename std::unordered_map<const io_context_t*, timer_t>;
 
+    struct chunk {
+        std::unique_ptr<expiring_request[]> requests;
+        std::size_t size;
+    };
+
     const std::size_t _capacity;
     mutable mutex_t _mutex;
-    typename expiring_request::list _ordered_requests_pool;
-    typename expiring_request::list _ordered_requests;
-    typename expiring_request::multimap _expires_at_requests;
+    std::vector<chunk> _chunks;
+    std::size_t _allocated = 0;
+    std::size_t _peak = 0;
+    requests_list _free_requests;
+    requests_list _ordered_requests;
+    requests_multiset _expires_at_requests;
     timers_map _timers;
+    resource_pool::detail::relaxed_value<std::size_t> _size;
+    resource_pool::detail::relaxed_value<std::uint64_t> _expired;
 
-    bool fit_capacity() const { return _expires_at_requests.size() < _capacity; }
+    bool fit_capacity() const { return !_free_requests.empty() || _allocated < _capacity; }
+    void grow();
+    void shrink();
+    queued_value_t take(list_it ordered_it);
     void cancel(boost::system::error_code ec, time_traits::time_point expires_at);
     void update_timer();
     timer_t& get_timer(io_context_t& io_context);
 };
 
-template <class V, class M, class I, class T>
-std::size_t queue<V, M, I, T>::size() const noexcept {
-    const lock_guard lock(_mutex);
-    return _expires_at_requests.size();
+template <class V, class M, class I, class T, class O, class TT, class L>
+std::size_t queue<V, M, I, T, O, TT, L>::size() const noexcept {
+    return _size.load();
 }
 
-template <class V, class M, class I, class T>
-bool queue<V, M, I, T>::empty() const noexcept {
+template <class V, class M, class I, class T, class O, class TT, class L>
+bool queue<V, M, I, T, O, TT, L>::empty() const noexcept {
+    return _size.load() == 0;
+}
+
+template <class V, class M, class I, class T, class O, class TT, class L>
+std::uint64_t queue<V, M, I, T, O, TT, L>::expired() const noexcept {
+    return _expired.load();
+}
+
+template <class V, class M, class I, class T, class O, class TT, class L>
+mutex_stats queue<V, M, I, T, O, TT, L>::lock_stats() const noexcept {
+    if constexpr (locked_by_pool) {
+        return {};
+    } else {
+        return resource_pool::detail::get_mutex_stats(_mutex);
+    }
+}
+
+template <class V, class M, class I, class T, class O, class TT, class L>
+resource_pool::memory_usage queue<V, M, I, T, O, TT, L>::memory_usage() const {
+    using resource_pool::detail::hash_node_size;
     const lock_guard lock(_mutex);
-    return _ordered_requests.empty();
+    resource_pool::memory_usage result;
+    result.queued = _ordered_requests.size();
+    result.free_queue_nodes = _free_requests.size();
+    result.queue_nodes = _allocated * sizeof(expiring_request)
+        + _chunks.capacity() * sizeof(chunk);
+    result.timers = _timers.size() * hash_node_size<typename timers_map::value_type>
+        + _timers.bucket_count() * sizeof(void*);
+    for (const auto& req : _ordered_requests) {
+        result.handlers += handler_memory_usage(req.request, 0);
+    }
+    return result;
 }
 
-template <class V, class M, class I, class T>
-const typename queue<V, M, I, T>::timer_t& queue<V, M, I, T>::timer(io_context_t& io_context) {
+template <class V, class M, class I, class T, class O, class TT, class L>
+const typename queue<V, M, I, T, O, TT, L>::timer_t& queue<V, M, I, T, O, TT, L>::timer(io_context_t& io_context) {
     const lock_guard lock(_mutex);
     return get_timer(io_context);
 }
 
-template <class V, class M, class I, class T>
-bool queue<V, M, I, T>::push(io_context_t& io_context, time_traits::duration wait_duration, value_type&& request) {
-    const lock_guard lock(_mutex);
+template <class V, class M, class I, class T, class O, class TT, class L>
+bool queue<V, M, I, T, O, TT, L>::push(io_context_t& io_context, time_traits::duration wait_duration, value_type&& request) {
+    const operation_lock lock(_mutex);
     if (!fit_capacity()) {
         return false;
     }
-    if (_ordered_requests_pool.empty()) {
-        _ordered_requests_pool.emplace_back();
+    if (_free_requests.empty()) {
+        grow();
     }
-    const auto order_it = _ordered_requests_pool.begin();
-    _ordered_requests.splice(_ordered_requests.end(), _ordered_requests_pool, order_it);
-    expiring_request& req = *order_it;
+    expiring_request& req = _free_requests.front();
+    _free_requests.pop_front();
+    _ordered_requests.push_back(req);
     req.io_context = std::addressof(io_context);
     req.request = std::move(request);
-    req.order_it = order_it;
-    const auto expires_at = time_traits::add(time_traits::now(), wait_duration);
-    req.expires_at_it = _expires_at_requests.insert(std::make_pair(expires_at, &req));
+    req.bypassed = 0;
+    req.enqueued_at = TT::now();
+    req.expires_at = time_traits::add(req.enqueued_at, wait_duration);
+    _expires_at_requests.insert(req);
+    _size.store(_expires_at_requests.size());
+    _peak = std::max(_peak, _expires_at_requests.size());
     update_timer();
     return true;
 }
 
-template <class V, class M, class I, class T>
-boost::optional<typename queue<V, M, I, T>::queued_value_t> queue<V, M, I, T>::pop() {
-    const lock_guard lock(_mutex);
+template <class V, class M, class I, class T, class O, class TT, class L>
+boost::optional<typename queue<V, M, I, T, O, TT, L>::queued_value_t> queue<V, M, I, T, O, TT, L>::pop() {
+    const operation_lock lock(_mutex);
     if (_ordered_requests.empty()) {
         return {};
     }
-    const auto ordered_it = _ordered_requests.begin();
+    return take(_ordered_requests.begin());
+}
+
+template <class V, class M, class I, class T, class O, class TT, class L>
+template <class Predicate>
+boost::optional<typename queue<V, M, I, T, O, TT, L>::queued_value_t> queue<V, M, I, T, O, TT, L>::pop_preferred(
+        Predicate&& predicate, std::size_t window) {
+    const operation_lock lock(_mutex);
+    if (_ordered_requests.empty()) {
+        return {};
+    }
+    const auto begin = _ordered_requests.begin();
+    auto selected = begin;
+    std::size_t scanned = 0;
+    for (auto it = begin; it != _ordered_requests.end() && scanned < window; ++it, ++scanned) {
+        if (it->bypassed >= window || predicate(*it->io_context)) {
+            selected = it;
+            break;
+        }
+    }
+    std::for_each(begin, selected, [] (expiring_request& req) { ++req.bypassed; });
+    return take(selected);
+}
+
+template <class V, class M, class I, class T, class O, class TT, class L>
+typename queue<V, M, I, T, O, TT, L>::queued_value_t queue<V, M, I, T, O, TT, L>::take(list_it ordered_it) {
     expiring_request& req = *ordered_it;
-    queued_value_t result {std::move(req.request), *req.io_context};
-    _expires_at_requests.erase(req.expires_at_it);
-    _ordered_requests_pool.splice(_ordered_requests_pool.begin(), _ordered_requests, ordered_it);
+    queued_value_t result {std::move(req.request), *req.io_context, req.enqueued_at};
+    _expires_at_requests.erase(_expires_at_requests.iterator_to(req));
+    _size.store(_expires_at_requests.size());
+    _ordered_requests.erase(ordered_it);
+    _free_requests.push_front(req);
+    shrink();
     update_timer();
-    return { std::move(result) };
+    return result;
 }
 
-template <class V, class M, class I, class T>
-void queue<V, M, I, T>::cancel(boost::system::error_code ec, time_traits::time_point expires_at) {
+template <class V, class M, class I, class T, class O, class TT, class L>
+void queue<V, M, I, T, O, TT, L>::cancel(boost::system::error_code ec, time_traits::time_point expires_at) {
     if (ec) {
         return;
     }
     const lock_guard lock(_mutex);
-    const auto begin = _expires_at_requests.begin();
-    const auto end = _expires_at_requests.upper_bound(expires_at);
-    std::for_each(begin, end, [&] (request_multimap_value& v) {
-        const auto req = v.second;
+    const auto now = TT::now();
+    const auto end = _expires_at_requests.upper_bound(expires_at, expires_at_less());
+    _expires_at_requests.erase_and_dispose(_expires_at_requests.begin(), end, [&] (expiring_request* req) {
+        observer_type::expire(now - req->enqueued_at);
         asio::post(*req->io_context, expired_handler(std::move(req->request)));
-        _ordered_requests_pool.splice(_ordered_requests_pool.begin(), _ordered_requests, req->order_it);
+        _ordered_requests.erase(_ordered_requests.iterator_to(*req));
+        _free_requests.push_front(*req);
+        ++_expired;
     });
-    _expires_at_requests.erase(_expires_at_requests.begin(), end);
+    _size.store(_expires_at_requests.size());
+    shrink();
     update_timer();
 }
 
-template <class V, class M, class I, class T>
-void queue<V, M, I, T>::update_timer() {
+template <class V, class M, class I, class T, class O, class TT, class L>
+void queue<V, M, I, T, O, TT, L>::grow() {
+    const auto count = std::min(std::max<std::size_t>(_allocated, 1), _capacity - _allocated);
+    _chunks.push_back(chunk {std::unique_ptr<expiring_request[]>(new expiring_request[count]), count});
+    std::for_each(_chunks.back().requests.get(), _chunks.back().requests.get() + count,
+        [&] (expiring_request& req) { _free_requests.push_back(req); });
+    _allocated += count;
+}
+
+// Drained queue keeps nodes for twice the peak of its last busy period and frees trailing chunks above that.
+template <class V, class M, class I, class T, class O, class TT, class L>
+void queue<V, M, I, T, O, TT, L>::shrink() {
+    if (!_expires_at_requests.empty()) {
+        return;
+    }
+    const auto keep = 2 * _peak;
+    _peak = 0;
+    if (_chunks.empty() || _allocated - _chunks.back().size < keep) {
+        return;
+    }
+    _free_requests.clear();
+    while (!_chunks.empty() && _allocated - _chunks.back().size >= keep) {
+        _allocated -= _chunks.back().size;
+        _chunks.pop_back();
+    }
+    for (const auto& c : _chunks) {
+        std::for_each(c.requests.get(), c.requests.get() + c.size,
+            [&] (expiring_request& req) { _free_requests.push_back(req); });
+    }
+}
+
+template <class V, class M, class I, class T, class O, class TT, class L>
+void queue<V, M, I, T, O, TT, L>::update_timer() {
     using timers_map_value = typename timers_map::value_type;
     if (_expires_at_requests.empty()) {
         std::for_each(_timers.begin(), _timers.end(), [] (timers_map_value& v) { v.second.cancel(); });
@@ -197,8 +357,8 @@ void queue<V, M, I, T>::update_timer() {
         return;
     }
     const auto earliest_expire = _expires_at_requests.begin();
-    const auto expires_at = earliest_expire->first;
-    auto& timer = get_timer(*earliest_expire->second->io_context);
+    const auto expires_at = earliest_expire->expires_at;
+    auto& timer = get_timer(*earliest_expire->io_context);
     timer.expires_at(expires_at);
     std::weak_ptr<queue> weak(this->shared_from_this());
     timer.async_wait([weak, expires_at] (boost::system::error_code ec) {
@@ -208,8 +368,8 @@ void queue<V, M, I, T>::update_timer() {
     });
 }
 
-template <class V, class M, class I, class T>
-typename queue<V, M, I, T>::timer_t& queue<V, M, I, T>::get_timer(io_context_t& io_context) {
+template <class V, class M, class I, class T, class O, class TT, class L>
+typename queue<V, M, I, T, O, TT, L>::timer_t& queue<V, M, I, T, O, TT, L>::get_timer(io_context_t& io_context) {
     auto it = _timers.find(&io_context);
     if (it != _timers.end()) {
         return it->second;
@@ -217,6 +377,12 @@ typename queue<V, M, I, T>::timer_t& queue<V, M, I, T>::get_timer(io_context_t&
     return _timers.emplace(&io_context, timer_t(io_context)).first->second;
 }
 
+template <class Queue, class = void>
+struct is_locked_by_pool : std::false_type {};
+
+template <class Queue>
+struct is_locked_by_pool<Queue, std::enable_if_t<Queue::locked_by_pool>> : std::true_type {};
+
 } // namespace detail
 } // namespace async
 } // namespace resource_pool
@@ -0,0 +1,331 @@
+#ifndef YAMAIL_RESOURCE_POOL_ASYNC_DETAIL_RING_QUEUE_HPP
+#define YAMAIL_RESOURCE_POOL_ASYNC_DETAIL_RING_QUEUE_HPP
+
+#include <yamail/resource_pool/async/detail/queue.hpp>
+
+#include <vector>
+
+namespace yamail {
+namespace resource_pool {
+namespace async {
+namespace detail {
+
+// Waiters are stored in arrival order in circular array of queue capacity. Waiters removed from the middle by
+// expiration or pop_preferred leave tombstones skipped by pop and reclaimed by compaction when array is full.
+// While each pushed deadline is not earlier than previous one deadlines are sorted in array order and expiration
+// visits only expired waiters, otherwise it scans the whole array.
+template <class Value, class Mutex, class IoContext, class Timer, class Observer = null_observer,
+          class TimeTraits = time_traits>
+class ring_queue : public std::enable_shared_from_this<ring_queue<Value, Mutex, IoContext, Timer, Observer, TimeTraits>> {
+public:
+    using value_type = Value;
+    using observer_type = Observer;
+    using time_traits_type = TimeTraits;
+    using io_context_t = IoContext;
+    using timer_t = Timer;
+    using queued_value_t = queued_value<value_type, io_context_t>;
+
+    ring_queue(std::size_t capacity) : _slots(capacity) {}
+
+    ring_queue(const ring_queue&) = delete;
+
+    ring_queue(ring_queue&&) = delete;
+
+    std::size_t capacity() const noexcept { return _slots.size(); }
+    std::size_t size() const noexcept { return _size.load(); }
+    bool empty() const noexcept { return _size.load() == 0; }
+    std::uint64_t expired() const noexcept { return _expired.load(); }
+    mutex_stats lock_stats() const noexcept { return resource_pool::detail::get_mutex_stats(_mutex); }
+    resource_pool::memory_usage memory_usage() const;
+    const timer_t& timer(io_context_t& io_context);
+
+    bool push(io_context_t& io_context, time_traits::duration wait_duration, value_type&& request);
+    boost::optional<queued_value_t> pop();
+    template <class Predicate>
+    boost::optional<queued_value_t> pop_preferred(Predicate&& predicate, std::size_t window);
+
+private:
+    using mutex_t = Mutex;
+    using lock_guard = std::lock_guard<mutex_t>;
+
+    struct slot {
+        io_context_t* io_context = nullptr;
+        value_type request;
+        time_traits::time_point enqueued_at;
+        time_traits::time_point expires_at;
+        std::size_t bypassed = 0;
+        bool alive = false;
+    };
+
+    using timers_map = typename std::unordered_map<const io_context_t*, timer_t>;
+
+    mutable mutex_t _mutex;
+    std::vector<slot> _slots;
+    std::size_t _head = 0;
+    std::size_t _used = 0;
+    std::size_t _alive = 0;
+    bool _sorted = true;
+    time_traits::time_point _last_expires_at;
+    boost::optional<time_traits::time_point> _timer_expires_at;
+    timers_map _timers;
+    resource_pool::detail::relaxed_value<std::size_t> _size;
+    resource_pool::detail::relaxed_value<std::uint64_t> _expired;
+
+    slot& at(std::size_t offset) {
+        const auto index = _head + offset;
+        return _slots[index < _slots.size() ? index : index - _slots.size()];
+    }
+
+    const slot& at(std::size_t offset) const {
+        const auto index = _head + offset;
+        return _slots[index < _slots.size() ? index : index - _slots.size()];
+    }
+
+    queued_value_t take(slot& value);
+    void bury(slot& value);
+    void skip_tombstones();
+    void compact();
+    void cancel(boost::system::error_code ec, time_traits::time_point expires_at);
+    void expire(slot& value, time_traits::time_point now);
+    void schedule(io_context_t& io_context, time_traits::time_point expires_at);
+    void update_timer();
+    timer_t& get_timer(io_context_t& io_context);
+};
+
+template <class V, class M, class I, class T, class O, class TT>
+resource_pool::memory_usage ring_queue<V, M, I, T, O, TT>::memory_usage() const {
+    using resource_pool::detail::hash_node_size;
+    const lock_guard lock(_mutex);
+    resource_pool::memory_usage result;
+    result.queued = _alive;
+    result.free_queue_nodes = _slots.size() - _used;
+    result.queue_nodes = _slots.capacity() * sizeof(slot);
+    result.timers = _timers.size() * hash_node_size<typename timers_map::value_type>
+        + _timers.bucket_count() * sizeof(void*);
+    for (std::size_t i = 0; i < _used; ++i) {
+        const auto& value = at(i);
+        if (value.alive) {
+            result.handlers += handler_memory_usage(value.request, 0);
+        }
+    }
+    return result;
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+const typename ring_queue<V, M, I, T, O, TT>::timer_t& ring_queue<V, M, I, T, O, TT>::timer(io_context_t& io_context) {
+    const lock_guard lock(_mutex);
+    return get_timer(io_context);
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+bool ring_queue<V, M, I, T, O, TT>::push(io_context_t& io_context, time_traits::duration wait_duration, value_type&& request) {
+    const lock_guard lock(_mutex);
+    if (_alive == _slots.size()) {
+        return false;
+    }
+    if (_used == _slots.size()) {
+        compact();
+    }
+    slot& value = at(_used++);
+    value.io_context = std::addressof(io_context);
+    value.request = std::move(request);
+    value.bypassed = 0;
+    value.alive = true;
+    value.enqueued_at = TT::now();
+    value.expires_at = time_traits::add(value.enqueued_at, wait_duration);
+    if (_alive == 0) {
+        _sorted = true;
+    } else if (value.expires_at < _last_expires_at) {
+        _sorted = false;
+    }
+    _last_expires_at = value.expires_at;
+    _size.store(++_alive);
+    if (!_timer_expires_at || value.expires_at < *_timer_expires_at) {
+        schedule(io_context, value.expires_at);
+    }
+    return true;
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+boost::optional<typename ring_queue<V, M, I, T, O, TT>::queued_value_t> ring_queue<V, M, I, T, O, TT>::pop() {
+    const lock_guard lock(_mutex);
+    if (_alive == 0) {
+        return {};
+    }
+    skip_tombstones();
+    return take(at(0));
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+template <class Predicate>
+boost::optional<typename ring_queue<V, M, I, T, O, TT>::queued_value_t> ring_queue<V, M, I, T, O, TT>::pop_preferred(
+        Predicate&& predicate, std::size_t window) {
+    const lock_guard lock(_mutex);
+    if (_alive == 0) {
+        return {};
+    }
+    skip_tombstones();
+    std::size_t selected = 0;
+    std::size_t scanned = 0;
+    for (std::size_t i = 0; i < _used && scanned < window; ++i) {
+        const auto& value = at(i);
+        if (!value.alive) {
+            continue;
+        }
+        if (value.bypassed >= window || predicate(*value.io_context)) {
+            selected = i;
+            break;
+        }
+        ++scanned;
+    }
+    for (std::size_t i = 0; i < selected; ++i) {
+        auto& value = at(i);
+        if (value.alive) {
+            ++value.bypassed;
+        }
+    }
+    return take(at(selected));
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+typename ring_queue<V, M, I, T, O, TT>::queued_value_t ring_queue<V, M, I, T, O, TT>::take(slot& value) {
+    queued_value_t result {std::move(value.request), *value.io_context, value.enqueued_at};
+    bury(value);
+    return result;
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+void ring_queue<V, M, I, T, O, TT>::bury(slot& value) {
+    value.alive = false;
+    _size.store(--_alive);
+    skip_tombstones();
+    if (_alive == 0) {
+        update_timer();
+    }
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+void ring_queue<V, M, I, T, O, TT>::skip_tombstones() {
+    while (_used > 0 && !at(0).alive) {
+        _head = _head + 1 == _slots.size() ? 0 : _head + 1;
+        --_used;
+    }
+    if (_used == 0) {
+        _head = 0;
+    }
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+void ring_queue<V, M, I, T, O, TT>::compact() {
+    std::size_t alive = 0;
+    for (std::size_t i = 0; i < _used; ++i) {
+        auto& value = at(i);
+        if (!value.alive) {
+            continue;
+        }
+        if (alive != i) {
+            auto& target = at(alive);
+            target.io_context = value.io_context;
+            target.request = std::move(value.request);
+            target.enqueued_at = value.enqueued_at;
+            target.expires_at = value.expires_at;
+            target.bypassed = value.bypassed;
+            target.alive = true;
+            value.alive = false;
+        }
+        ++alive;
+    }
+    _used = alive;
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+void ring_queue<V, M, I, T, O, TT>::cancel(boost::system::error_code ec, time_traits::time_point expires_at) {
+    if (ec) {
+        return;
+    }
+    const lock_guard lock(_mutex);
+    if (!_timer_expires_at || *_timer_expires_at != expires_at) {
+        return;
+    }
+    _timer_expires_at.reset();
+    const auto now = TT::now();
+    if (_sorted) {
+        while (_used > 0 && at(0).expires_at <= expires_at) {
+            expire(at(0), now);
+            skip_tombstones();
+        }
+    } else {
+        for (std::size_t i = 0; i < _used; ++i) {
+            auto& value = at(i);
+            if (value.alive && value.expires_at <= expires_at) {
+                expire(value, now);
+            }
+        }
+        skip_tombstones();
+    }
+    update_timer();
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+void ring_queue<V, M, I, T, O, TT>::expire(slot& value, time_traits::time_point now) {
+    observer_type::expire(now - value.enqueued_at);
+    asio::post(*value.io_context, expired_handler(std::move(value.request)));
+    value.alive = false;
+    _size.store(--_alive);
+    ++_expired;
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+void ring_queue<V, M, I, T, O, TT>::schedule(io_context_t& io_context, time_traits::time_point expires_at) {
+    auto& timer = get_timer(io_context);
+    timer.expires_at(expires_at);
+    _timer_expires_at = expires_at;
+    std::weak_ptr<ring_queue> weak(this->shared_from_this());
+    timer.async_wait([weak, expires_at] (boost::system::error_code ec) {
+        if (const auto locked = weak.lock()) {
+            locked->cancel(ec, expires_at);
+        }
+    });
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+void ring_queue<V, M, I, T, O, TT>::update_timer() {
+    using timers_map_value = typename timers_map::value_type;
+    if (_alive == 0) {
+        std::for_each(_timers.begin(), _timers.end(), [] (timers_map_value& v) { v.second.cancel(); });
+        _timers.clear();
+        _timer_expires_at.reset();
+        return;
+    }
+    if (_timer_expires_at) {
+        return;
+    }
+    const slot* earliest = nullptr;
+    if (_sorted) {
+        earliest = &at(0);
+    } else {
+        for (std::size_t i = 0; i < _used; ++i) {
+            const auto& value = at(i);
+            if (value.alive && (earliest == nullptr || value.expires_at < earliest->expires_at)) {
+                earliest = &value;
+            }
+        }
+    }
+    schedule(*earliest->io_context, earliest->expires_at);
+}
+
+template <class V, class M, class I, class T, class O, class TT>
+typename ring_queue<V, M, I, T, O, TT>::timer_t& ring_queue<V, M, I, T, O, TT>::get_timer(io_context_t& io_context) {
+    auto it = _timers.find(&io_context);
+    if (it != _timers.end()) {
+        return it->second;
+    }
+    return _timers.emplace(&io_context, timer_t(io_context)).first->second;
+}
+
+} // namespace detail
+} // namespace async
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_ASYNC_DETAIL_RING_QUEUE_HPP
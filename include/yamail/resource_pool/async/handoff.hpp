@@ -0,0 +1,36 @@
+#ifndef YAMAIL_RESOURCE_POOL_ASYNC_HANDOFF_HPP
+#define YAMAIL_RESOURCE_POOL_ASYNC_HANDOFF_HPP
+
+#include <cstddef>
+
+namespace yamail {
+namespace resource_pool {
+namespace async {
+
+struct fifo_handoff {
+    template <class Queue>
+    static auto pop(Queue& queue) {
+        return queue.pop();
+    }
+};
+
+template <std::size_t Window>
+struct affinity_handoff {
+    static_assert(Window > 0, "Window should be greater than 0");
+
+    static constexpr std::size_t window = Window;
+
+    template <class Queue>
+    static auto pop(Queue& queue) {
+        return queue.pop_preferred(
+            [] (auto& io_context) { return io_context.get_executor().running_in_this_thread(); },
+            window
+        );
+    }
+};
+
+} // namespace async
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_ASYNC_HANDOFF_HPP
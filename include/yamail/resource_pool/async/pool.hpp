@@ -1,9 +1,12 @@
 #ifndef YAMAIL_RESOURCE_POOL_ASYNC_POOL_HPP
 #define YAMAIL_RESOURCE_POOL_ASYNC_POOL_HPP
 
+#include <yamail/resource_pool/call_site.hpp>
 #include <yamail/resource_pool/error.hpp>
 #include <yamail/resource_pool/handle.hpp>
 #include <yamail/resource_pool/async/detail/pool_impl.hpp>
+#include <yamail/resource_pool/async/detail/ring_queue.hpp>
+#include <yamail/resource_pool/detail/numa_storage.hpp>
 
 #include <boost/asio/io_context.hpp>
 
@@ -11,7 +14,26 @@ namespace yamail {
 namespace resource_pool {
 namespace async {
 
-template <class Value, class Mutex, class IoContext>
+// Waiters ordered by arrival and by deadline in nodes allocated on demand and released after queue drains.
+struct deadline_ordered_queue {
+    template <class... Args>
+    using type = detail::queue<Args...>;
+};
+
+// Waiters in preallocated circular array, cheaper when all requests use the same wait duration.
+struct ring_buffer_queue {
+    template <class... Args>
+    using type = detail::ring_queue<Args...>;
+};
+
+// Same as deadline_ordered_queue but guarded by pool mutex, so get, recycle and waste take single lock.
+struct combined_lock_queue {
+    template <class... Args>
+    using type = detail::queue<Args..., detail::pool_lock>;
+};
+
+template <class Value, class Mutex, class IoContext, class Observer = null_observer,
+          class TimeTraits = time_traits, class QueueKind = deadline_ordered_queue>
 struct default_pool_queue {
     using value_type = Value;
     using io_context_t = IoContext;
@@ -19,16 +41,23 @@ struct default_pool_queue {
     using idle = resource_pool::detail::idle<value_type>;
     using list = std::list<idle>;
     using list_iterator = typename list::iterator;
-    using type = detail::queue<detail::list_iterator_handler<value_type>, mutex_t, io_context_t, time_traits::timer>;
+    using type = typename QueueKind::template type<detail::list_iterator_handler<value_type>, mutex_t, io_context_t,
+        typename TimeTraits::timer, Observer, TimeTraits>;
 };
 
-template <class Value, class Mutex, class IoContext>
+template <class Value, class Mutex, class IoContext, class Handoff = fifo_handoff,
+          class Storage = resource_pool::detail::storage<Value>, class Observer = null_observer,
+          class QueueKind = deadline_ordered_queue>
 struct default_pool_impl {
     using type = typename detail::pool_impl<
         Value,
         Mutex,
         IoContext,
-        typename default_pool_queue<Value, Mutex, IoContext>::type
+        typename default_pool_queue<Value, Mutex, IoContext, Observer, typename Storage::time_traits_type,
+            QueueKind>::type,
+        Handoff,
+        Storage,
+        Observer
     >;
 };
 
@@ -96,23 +125,30 @@ public:
     std::size_t size() const noexcept { return _impl->size(); }
     std::size_t available() const noexcept { return _impl->available(); }
     std::size_t used() const noexcept { return _impl->used(); }
+    // With combined_lock_queue field mutex reports the single lock and queue_mutex is zero.
     async::stats stats() const noexcept { return _impl->stats(); }
+    latency_stats latency() const noexcept { return _impl->latency(); }
+    resource_pool::memory_usage memory_usage() const { return _impl->memory_usage(); }
+    auto node_stats() const { return _impl->node_stats(); }
 
     const pool_impl& impl() const noexcept { return *_impl; }
+    std::shared_ptr<const pool_impl> shared_impl() const noexcept { return _impl; }
 
     template <class CompletionToken>
     auto get_auto_waste(io_context_t& io_context, CompletionToken&& token,
-                        time_traits::duration wait_duration = time_traits::duration(0)) {
+                        time_traits::duration wait_duration = time_traits::duration(0),
+                        call_site site = call_site::current()) {
         async_completion<CompletionToken> init(token);
-        get(io_context, std::move(init.completion_handler), &handle::waste, wait_duration);
+        get(io_context, std::move(init.completion_handler), &handle::waste, wait_duration, site);
         return init.result.get();
     }
 
     template <class CompletionToken>
     auto get_auto_recycle(io_context_t& io_context, CompletionToken&& token,
-                          time_traits::duration wait_duration = time_traits::duration(0)) {
+                          time_traits::duration wait_duration = time_traits::duration(0),
+                          call_site site = call_site::current()) {
         async_completion<CompletionToken> init(token);
-        get(io_context, std::move(init.completion_handler), &handle::recycle, wait_duration);
+        get(io_context, std::move(init.completion_handler), &handle::recycle, wait_duration, site);
         return init.result.get();
     }
 
@@ -130,15 +166,17 @@ private:
     class on_get_handler {
         std::shared_ptr<pool_impl> impl;
         UseStrategy use_strategy;
+        call_site site;
         Handler handler;
 
     public:
         using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler))>;
 
         template <class HandlerT>
-        on_get_handler(std::shared_ptr<pool_impl> impl, UseStrategy use_strategy, HandlerT&& handler)
+        on_get_handler(std::shared_ptr<pool_impl> impl, UseStrategy use_strategy, call_site site, HandlerT&& handler)
             : impl(std::move(impl)),
               use_strategy(std::move(use_strategy)),
+              site(site),
               handler(std::forward<HandlerT>(handler)) {
             static_assert(std::is_same<std::decay_t<HandlerT>, Handler>::value, "HandlerT is not Handler");
         }
@@ -147,6 +185,7 @@ private:
             if (ec) {
                 handler(ec, handle());
             } else {
+                resource_pool::detail::set_lease_site(*res, site);
                 handler(ec, handle(impl, use_strategy, std::move(res)));
             }
         }
@@ -157,23 +196,112 @@ private:
     };
 
     template <class UseStrategy, class Handler>
-    auto make_on_get_handler(UseStrategy&& use_strategy, Handler&& handler) {
+    auto make_on_get_handler(UseStrategy&& use_strategy, call_site site, Handler&& handler) {
         using result_type = on_get_handler<std::decay_t<UseStrategy>, std::decay_t<Handler>>;
-        return result_type(_impl, std::forward<UseStrategy>(use_strategy), std::forward<Handler>(handler));
+        return result_type(_impl, std::forward<UseStrategy>(use_strategy), site, std::forward<Handler>(handler));
     }
 
     std::shared_ptr<pool_impl> _impl;
 
     template <class UseStrategy, class Handler>
-    void get(io_context_t &io_context, Handler&& handler, UseStrategy&& use_strategy, time_traits::duration wait_duration) {
+    void get(io_context_t &io_context, Handler&& handler, UseStrategy&& use_strategy, time_traits::duration wait_duration,
+             call_site site) {
         _impl->get(
             io_context,
-            make_on_get_handler(std::forward<UseStrategy>(use_strategy), std::forward<Handler>(handler)),
+            make_on_get_handler(std::forward<UseStrategy>(use_strategy), site, std::forward<Handler>(handler)),
             wait_duration
         );
     }
 };
 
+template <class Value,
+          class Mutex = std::mutex,
+          class IoContext = boost::asio::io_context,
+          class Topology = numa_topology>
+using numa_pool = pool<
+    Value,
+    Mutex,
+    IoContext,
+    typename default_pool_impl<
+        Value,
+        Mutex,
+        IoContext,
+        fifo_handoff,
+        resource_pool::detail::numa_storage<Value, Topology>
+    >::type
+>;
+
+template <class Value,
+          class Observer,
+          class Mutex = std::mutex,
+          class IoContext = boost::asio::io_context>
+using observed_pool = pool<
+    Value,
+    Mutex,
+    IoContext,
+    typename default_pool_impl<
+        Value,
+        Mutex,
+        IoContext,
+        fifo_handoff,
+        resource_pool::detail::storage<Value>,
+        Observer
+    >::type
+>;
+
+template <class Value,
+          class TimeTraits,
+          class Mutex = std::mutex,
+          class IoContext = boost::asio::io_context>
+using timed_pool = pool<
+    Value,
+    Mutex,
+    IoContext,
+    typename default_pool_impl<
+        Value,
+        Mutex,
+        IoContext,
+        fifo_handoff,
+        resource_pool::detail::storage<Value, TimeTraits>
+    >::type
+>;
+
+template <class Value,
+          class Mutex = std::mutex,
+          class IoContext = boost::asio::io_context>
+using ring_pool = pool<
+    Value,
+    Mutex,
+    IoContext,
+    typename default_pool_impl<
+        Value,
+        Mutex,
+        IoContext,
+        fifo_handoff,
+        resource_pool::detail::storage<Value>,
+        null_observer,
+        ring_buffer_queue
+    >::type
+>;
+
+template <class Value,
+          class Mutex = std::mutex,
+          class IoContext = boost::asio::io_context>
+using combined_lock_pool = pool<
+    Value,
+    Mutex,
+    IoContext,
+    typename default_pool_impl<
+        Value,
+        Mutex,
+        IoContext,
+        fifo_handoff,
+        resource_pool::detail::storage<Value>,
+        null_observer,
+        combined_lock_queue
+    >::type
+>;
+
 } // namespace async
 } // namespace resource_pool
 } // namespace yamail
@@ -0,0 +1,27 @@
+#ifndef YAMAIL_RESOURCE_POOL_CALL_SITE_HPP
+#define YAMAIL_RESOURCE_POOL_CALL_SITE_HPP
+
+#ifndef YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE
+#ifdef NDEBUG
+#define YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE 0
+#else
+#define YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE 1
+#endif
+#endif
+
+namespace yamail {
+namespace resource_pool {
+
+struct call_site {
+    const char* file = nullptr;
+    unsigned line = 0;
+
+    static constexpr call_site current(const char* file = __builtin_FILE(), unsigned line = __builtin_LINE()) noexcept {
+        return call_site {file, line};
+    }
+};
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_CALL_SITE_HPP
@@ -0,0 +1,84 @@
+#ifndef YAMAIL_RESOURCE_POOL_COUNTERS_HPP
+#define YAMAIL_RESOURCE_POOL_COUNTERS_HPP
+
+#include <yamail/resource_pool/error.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace yamail {
+namespace resource_pool {
+
+struct pool_counters {
+    std::uint64_t idle_leases = 0;
+    std::uint64_t empty_leases = 0;
+    std::uint64_t idle_timeout_expirations = 0;
+    std::uint64_t lifespan_expirations = 0;
+    std::uint64_t invalidated_recycles = 0;
+    std::uint64_t get_resource_timeouts = 0;
+    std::uint64_t request_queue_overflows = 0;
+    std::uint64_t disabled = 0;
+};
+
+namespace detail {
+
+struct storage_counters {
+    std::uint64_t idle_leases = 0;
+    std::uint64_t empty_leases = 0;
+    std::uint64_t idle_timeout_expirations = 0;
+    std::uint64_t lifespan_expirations = 0;
+    std::uint64_t invalidated_recycles = 0;
+
+    storage_counters& operator +=(const storage_counters& other) noexcept {
+        idle_leases += other.idle_leases;
+        empty_leases += other.empty_leases;
+        idle_timeout_expirations += other.idle_timeout_expirations;
+        lifespan_expirations += other.lifespan_expirations;
+        invalidated_recycles += other.invalidated_recycles;
+        return *this;
+    }
+};
+
+class error_counters {
+public:
+    void count(error::code value) noexcept {
+        switch (value) {
+            case error::get_resource_timeout:
+                get_resource_timeouts_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case error::request_queue_overflow:
+                request_queue_overflows_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case error::disabled:
+                disabled_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            default:
+                break;
+        }
+    }
+
+    pool_counters make_pool_counters(const storage_counters& storage) const noexcept {
+        pool_counters result;
+        result.idle_leases = storage.idle_leases;
+        result.empty_leases = storage.empty_leases;
+        result.idle_timeout_expirations = storage.idle_timeout_expirations;
+        result.lifespan_expirations = storage.lifespan_expirations;
+        result.invalidated_recycles = storage.invalidated_recycles;
+        result.get_resource_timeouts = get_resource_timeouts_.load(std::memory_order_relaxed);
+        result.request_queue_overflows = request_queue_overflows_.load(std::memory_order_relaxed);
+        result.disabled = disabled_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    std::atomic<std::uint64_t> get_resource_timeouts_ {0};
+    std::atomic<std::uint64_t> request_queue_overflows_ {0};
+    std::atomic<std::uint64_t> disabled_ {0};
+};
+
+} // namespace detail
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_COUNTERS_HPP
@@ -1,10 +1,13 @@
 #ifndef YAMAIL_RESOURCE_POOL_DETAIL_IDLE_HPP
 #define YAMAIL_RESOURCE_POOL_DETAIL_IDLE_HPP
 
+#include <yamail/resource_pool/call_site.hpp>
 #include <yamail/resource_pool/time_traits.hpp>
 
 #include <boost/optional.hpp>
 
+#include <atomic>
+
 namespace yamail {
 namespace resource_pool {
 namespace detail {
@@ -16,7 +19,14 @@ struct idle {
     boost::optional<value_type> value;
     time_traits::time_point drop_time;
     time_traits::time_point reset_time;
+    time_traits::time_point lease_time;
     bool waste_on_recycle = false;
+    // Storage partition owning the cell. Fits into padding after waste_on_recycle, so cell size does not grow.
+    unsigned partition = 0;
+#if YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE
+    std::atomic<const char*> lease_file {nullptr};
+    std::atomic<unsigned> lease_line {0};
+#endif
 
     idle(time_traits::time_point drop_time = time_traits::time_point::max())
         : drop_time(drop_time) {}
@@ -24,6 +34,27 @@ struct idle {
         : value(std::move(value)), drop_time(drop_time), reset_time(reset_time) {}
 };
 
+template <class Value>
+void set_lease_site(idle<Value>& cell, call_site site) noexcept {
+#if YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE
+    cell.lease_file.store(site.file, std::memory_order_relaxed);
+    cell.lease_line.store(site.line, std::memory_order_relaxed);
+#else
+    static_cast<void>(cell);
+    static_cast<void>(site);
+#endif
+}
+
+template <class Value>
+call_site get_lease_site(const idle<Value>& cell) noexcept {
+#if YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE
+    return call_site {cell.lease_file.load(std::memory_order_relaxed), cell.lease_line.load(std::memory_order_relaxed)};
+#else
+    static_cast<void>(cell);
+    return call_site {};
+#endif
+}
+
 } // namespace detail
 } // namespace resource_pool
 } // namespace yamail
@@ -0,0 +1,187 @@
+#ifndef YAMAIL_RESOURCE_POOL_DETAIL_NUMA_STORAGE_HPP
+#define YAMAIL_RESOURCE_POOL_DETAIL_NUMA_STORAGE_HPP
+
+#include <yamail/resource_pool/numa_topology.hpp>
+#include <yamail/resource_pool/detail/storage.hpp>
+
+#include <vector>
+
+namespace yamail {
+namespace resource_pool {
+namespace detail {
+
+template <class T, class Topology = numa_topology>
+class numa_storage {
+public:
+    using topology_type = Topology;
+    using time_traits_type = time_traits;
+    using cell_iterator = typename storage<T>::cell_iterator;
+    using const_cell_iterator = typename storage<T>::const_cell_iterator;
+
+    inline numa_storage(std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan);
+
+    template <class Generator>
+    inline numa_storage(Generator&& generator, std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan);
+
+    numa_storage(const numa_storage& other) = delete;
+
+    numa_storage(numa_storage&& other) = default;
+
+    const topology_type& topology() const noexcept { return topology_; }
+
+    inline storage_stats stats() const;
+
+    inline storage_counters counters() const;
+
+    inline std::vector<storage_stats> node_stats() const;
+
+    inline std::size_t memory_usage() const;
+
+    inline boost::optional<cell_iterator> lease();
+
+    inline void recycle(cell_iterator cell);
+
+    inline void waste(cell_iterator cell);
+
+    inline bool is_valid(const_cell_iterator cell) const;
+
+    inline bool validate(cell_iterator cell);
+
+    inline std::size_t partition(const_cell_iterator cell) const;
+
+    inline void invalidate();
+
+    template <class Function>
+    void for_each_used(Function&& function) const {
+        for (const auto& partition : partitions_) {
+            partition.for_each_used(function);
+        }
+    }
+
+private:
+    topology_type topology_;
+    std::vector<storage<T>> partitions_;
+
+    inline void mark_partitions();
+
+    std::size_t partition_capacity(std::size_t capacity, std::size_t partition) const {
+        const auto nodes = topology_.nodes();
+        return capacity / nodes + (partition < capacity % nodes ? 1 : 0);
+    }
+};
+
+template <class T, class Topology>
+numa_storage<T, Topology>::numa_storage(std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan) {
+    partitions_.reserve(topology_.nodes());
+    for (std::size_t i = 0; i < topology_.nodes(); ++i) {
+        partitions_.emplace_back(partition_capacity(capacity, i), idle_timeout, lifespan);
+    }
+    mark_partitions();
+}
+
+template <class T, class Topology>
+template <class Generator>
+numa_storage<T, Topology>::numa_storage(Generator&& generator, std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan) {
+    partitions_.reserve(topology_.nodes());
+    for (std::size_t i = 0; i < topology_.nodes(); ++i) {
+        partitions_.emplace_back(generator, partition_capacity(capacity, i), idle_timeout, lifespan);
+    }
+    mark_partitions();
+}
+
+template <class T, class Topology>
+void numa_storage<T, Topology>::mark_partitions() {
+    for (std::size_t i = 0; i < partitions_.size(); ++i) {
+        partitions_[i].for_each_cell([&] (idle<T>& cell) { cell.partition = static_cast<unsigned>(i); });
+    }
+}
+
+template <class T, class Topology>
+storage_stats numa_storage<T, Topology>::stats() const {
+    storage_stats result {0, 0, 0};
+    for (const auto& partition : partitions_) {
+        const auto stats = partition.stats();
+        result.available += stats.available;
+        result.used += stats.used;
+        result.wasted += stats.wasted;
+    }
+    return result;
+}
+
+template <class T, class Topology>
+storage_counters numa_storage<T, Topology>::counters() const {
+    storage_counters result;
+    for (const auto& partition : partitions_) {
+        result += partition.counters();
+    }
+    return result;
+}
+
+template <class T, class Topology>
+std::size_t numa_storage<T, Topology>::memory_usage() const {
+    std::size_t result = partitions_.capacity() * sizeof(storage<T>);
+    for (const auto& partition : partitions_) {
+        result += partition.memory_usage();
+    }
+    return result;
+}
+
+template <class T, class Topology>
+std::vector<storage_stats> numa_storage<T, Topology>::node_stats() const {
+    std::vector<storage_stats> result;
+    result.reserve(partitions_.size());
+    for (const auto& partition : partitions_) {
+        result.push_back(partition.stats());
+    }
+    return result;
+}
+
+template <class T, class Topology>
+boost::optional<typename numa_storage<T, Topology>::cell_iterator> numa_storage<T, Topology>::lease() {
+    const auto local = topology_.current_node() % partitions_.size();
+    for (std::size_t i = 0; i < partitions_.size(); ++i) {
+        const auto partition = (local + i) % partitions_.size();
+        if (const auto cell = partitions_[partition].lease()) {
+            return cell;
+        }
+    }
+    return {};
+}
+
+template <class T, class Topology>
+void numa_storage<T, Topology>::recycle(cell_iterator cell) {
+    partitions_[partition(cell)].recycle(cell);
+}
+
+template <class T, class Topology>
+void numa_storage<T, Topology>::waste(cell_iterator cell) {
+    partitions_[partition(cell)].waste(cell);
+}
+
+template <class T, class Topology>
+bool numa_storage<T, Topology>::is_valid(const_cell_iterator cell) const {
+    return partitions_[partition(cell)].is_valid(cell);
+}
+
+template <class T, class Topology>
+bool numa_storage<T, Topology>::validate(cell_iterator cell) {
+    return partitions_[partition(cell)].validate(cell);
+}
+
+template <class T, class Topology>
+std::size_t numa_storage<T, Topology>::partition(const_cell_iterator cell) const {
+    return cell->partition;
+}
+
+template <class T, class Topology>
+void numa_storage<T, Topology>::invalidate() {
+    for (auto& partition : partitions_) {
+        partition.invalidate();
+    }
+}
+
+} // namespace detail
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_DETAIL_NUMA_STORAGE_HPP
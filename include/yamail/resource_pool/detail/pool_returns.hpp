@@ -14,6 +14,8 @@ struct pool_returns {
     virtual void waste(cell_iterator<T> resource_iterator) = 0;
 
     virtual void recycle(cell_iterator<T> resource_iterator) = 0;
+
+    virtual time_traits::time_point now() const { return time_traits::now(); }
 };
 
 } // namespace detail
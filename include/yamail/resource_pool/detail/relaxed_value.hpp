@@ -0,0 +1,43 @@
+#ifndef YAMAIL_RESOURCE_POOL_DETAIL_RELAXED_VALUE_HPP
+#define YAMAIL_RESOURCE_POOL_DETAIL_RELAXED_VALUE_HPP
+
+#include <atomic>
+
+namespace yamail {
+namespace resource_pool {
+namespace detail {
+
+// Value written by one thread at a time (under external lock) and read concurrently without lock.
+template <class T>
+class relaxed_value {
+public:
+    relaxed_value(T value = T()) noexcept : value_(value) {}
+    relaxed_value(const relaxed_value& other) noexcept : value_(other.load()) {}
+
+    relaxed_value& operator =(const relaxed_value& other) noexcept {
+        store(other.load());
+        return *this;
+    }
+
+    T load() const noexcept { return value_.load(std::memory_order_relaxed); }
+    void store(T value) noexcept { value_.store(value, std::memory_order_relaxed); }
+
+    relaxed_value& operator ++() noexcept {
+        store(load() + 1);
+        return *this;
+    }
+
+    relaxed_value& operator --() noexcept {
+        store(load() - 1);
+        return *this;
+    }
+
+private:
+    std::atomic<T> value_;
+};
+
+} // namespace detail
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_DETAIL_RELAXED_VALUE_HPP
@@ -0,0 +1,38 @@
+#ifndef YAMAIL_RESOURCE_POOL_DETAIL_SPIN_HPP
+#define YAMAIL_RESOURCE_POOL_DETAIL_SPIN_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+namespace yamail {
+namespace resource_pool {
+namespace detail {
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+template <class Predicate>
+bool spin_until(Predicate&& predicate, std::size_t spins, std::size_t max_pause) noexcept {
+    std::size_t pause = 1;
+    for (std::size_t i = 0; i < spins; ++i) {
+        if (predicate()) {
+            return true;
+        }
+        for (std::size_t j = 0; j < pause; ++j) {
+            cpu_relax();
+        }
+        pause = std::min(pause * 2, std::max(max_pause, std::size_t(1)));
+    }
+    return predicate();
+}
+
+} // namespace detail
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_DETAIL_SPIN_HPP
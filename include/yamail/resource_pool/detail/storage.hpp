@@ -1,8 +1,11 @@
 #pragma once
 
+#include <yamail/resource_pool/counters.hpp>
 #include <yamail/resource_pool/error.hpp>
+#include <yamail/resource_pool/memory_usage.hpp>
 #include <yamail/resource_pool/time_traits.hpp>
 #include <yamail/resource_pool/detail/idle.hpp>
+#include <yamail/resource_pool/detail/relaxed_value.hpp>
 
 #include <algorithm>
 #include <list>
@@ -17,9 +20,10 @@ struct storage_stats {
     std::size_t wasted;
 };
 
-template <class T>
+template <class T, class TimeTraits = time_traits>
 class storage {
 public:
+    using time_traits_type = TimeTraits;
     using cell_iterator = typename std::list<idle<T>>::iterator;
     using const_cell_iterator = typename std::list<idle<T>>::iterator;
 
@@ -37,6 +41,10 @@ public:
 
     inline storage_stats stats() const;
 
+    inline storage_counters counters() const;
+
+    inline std::size_t memory_usage() const;
+
     inline boost::optional<cell_iterator> lease();
 
     inline void recycle(cell_iterator cell);
@@ -45,14 +53,49 @@ public:
 
     inline bool is_valid(const_cell_iterator cell) const;
 
+    inline bool validate(cell_iterator cell);
+
     inline void invalidate();
 
+    template <class Function>
+    void for_each_used(Function&& function) const {
+        for (const auto& cell : used_) {
+            function(cell);
+        }
+    }
+
+    template <class Function>
+    void for_each_cell(Function&& function) {
+        for (auto* cells : {&available_, &used_, &wasted_}) {
+            for (auto& cell : *cells) {
+                function(cell);
+            }
+        }
+    }
+
 private:
     time_traits::duration idle_timeout_;
     time_traits::duration lifespan_;
     std::list<idle<T>> available_;
     std::list<idle<T>> used_;
     std::list<idle<T>> wasted_;
+    relaxed_value<std::size_t> available_size_;
+    relaxed_value<std::size_t> used_size_;
+    relaxed_value<std::size_t> wasted_size_;
+
+    struct {
+        relaxed_value<std::uint64_t> idle_leases;
+        relaxed_value<std::uint64_t> empty_leases;
+        relaxed_value<std::uint64_t> idle_timeout_expirations;
+        relaxed_value<std::uint64_t> lifespan_expirations;
+        relaxed_value<std::uint64_t> invalidated_recycles;
+    } counters_;
+
+    void update_sizes() noexcept {
+        available_size_.store(available_.size());
+        used_size_.store(used_.size());
+        wasted_size_.store(wasted_.size());
+    }
 };
 
 template <class T>
@@ -61,91 +104,127 @@ using cell_iterator = typename storage<T>::cell_iterator;
 template <class CellIterator>
 using cell_value = typename CellIterator::value_type::value_type;
 
-template <class T>
-storage<T>::storage(std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan)
+template <class T, class TT>
+storage<T, TT>::storage(std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan)
         : idle_timeout_(idle_timeout),
           lifespan_(lifespan),
           wasted_(capacity) {
+    update_sizes();
 }
 
-template <class T>
+template <class T, class TT>
 template <class Generator>
-storage<T>::storage(Generator&& generator, std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan)
+storage<T, TT>::storage(Generator&& generator, std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan)
         : idle_timeout_(idle_timeout), lifespan_(lifespan) {
-    const auto now = time_traits::now();
+    const auto now = TT::now();
     const auto drop_time = std::min(time_traits::add(now, idle_timeout_), time_traits::add(now, lifespan_));
     for (std::size_t i = 0; i < capacity; ++i) {
         available_.emplace_back(generator(), drop_time, now);
     }
+    update_sizes();
 }
 
-template <class T>
+template <class T, class TT>
 template <class InputIterator>
-storage<T>::storage(InputIterator begin, InputIterator end, time_traits::duration idle_timeout, time_traits::duration lifespan)
+storage<T, TT>::storage(InputIterator begin, InputIterator end, time_traits::duration idle_timeout, time_traits::duration lifespan)
         : idle_timeout_(idle_timeout), lifespan_(lifespan) {
-    const auto now = time_traits::now();
+    const auto now = TT::now();
     const auto drop_time = std::min(time_traits::add(now, idle_timeout_), time_traits::add(now, lifespan_));
     std::for_each(begin, end, [&] (auto&& v) {
         available_.emplace_back(std::forward<decltype(v)>(v), drop_time, now);
     });
+    update_sizes();
 }
 
-template <class T>
-storage_stats storage<T>::stats() const {
+template <class T, class TT>
+storage_stats storage<T, TT>::stats() const {
     storage_stats result;
-    result.available = available_.size();
-    result.used = used_.size();
-    result.wasted = wasted_.size();
+    result.available = available_size_.load();
+    result.used = used_size_.load();
+    result.wasted = wasted_size_.load();
     return result;
 }
 
-template <class T>
-boost::optional<typename storage<T>::cell_iterator> storage<T>::lease() {
-    const auto now = time_traits::now();
+template <class T, class TT>
+storage_counters storage<T, TT>::counters() const {
+    storage_counters result;
+    result.idle_leases = counters_.idle_leases.load();
+    result.empty_leases = counters_.empty_leases.load();
+    result.idle_timeout_expirations = counters_.idle_timeout_expirations.load();
+    result.lifespan_expirations = counters_.lifespan_expirations.load();
+    result.invalidated_recycles = counters_.invalidated_recycles.load();
+    return result;
+}
+
+template <class T, class TT>
+std::size_t storage<T, TT>::memory_usage() const {
+    const auto cells = available_size_.load() + used_size_.load() + wasted_size_.load();
+    return cells * list_node_size<idle<T>>;
+}
+
+template <class T, class TT>
+boost::optional<typename storage<T, TT>::cell_iterator> storage<T, TT>::lease() {
+    const auto now = TT::now();
     while (!available_.empty()) {
         const auto candidate = available_.begin();
         if (candidate->drop_time > now) {
+            candidate->lease_time = now;
             used_.splice(used_.end(), available_, candidate);
+            update_sizes();
+            ++counters_.idle_leases;
             return candidate;
         }
+        if (time_traits::add(candidate->reset_time, lifespan_) <= now) {
+            ++counters_.lifespan_expirations;
+        } else {
+            ++counters_.idle_timeout_expirations;
+        }
         candidate->value.reset();
         wasted_.splice(wasted_.end(), available_, candidate);
     }
     if (!wasted_.empty()) {
         const auto result = wasted_.begin();
         result->waste_on_recycle = false;
+        result->lease_time = now;
         used_.splice(used_.end(), wasted_, result);
+        update_sizes();
+        ++counters_.empty_leases;
         return result;
     }
+    update_sizes();
     return {};
 }
 
-template <class T>
-void storage<T>::recycle(typename storage<T>::cell_iterator cell) {
+template <class T, class TT>
+void storage<T, TT>::recycle(typename storage<T, TT>::cell_iterator cell) {
     if (cell->waste_on_recycle) {
+        ++counters_.invalidated_recycles;
         return waste(cell);
     }
-    const auto now = time_traits::now();
+    const auto now = TT::now();
     const auto life_end = time_traits::add(cell->reset_time, lifespan_);
     if (life_end <= now) {
+        ++counters_.lifespan_expirations;
         return waste(cell);
     }
     cell->drop_time = std::min(time_traits::add(now, idle_timeout_), life_end);
     available_.splice(available_.end(), used_, cell);
+    update_sizes();
 }
 
-template <class T>
-void storage<T>::waste(typename storage<T>::cell_iterator cell) {
+template <class T, class TT>
+void storage<T, TT>::waste(typename storage<T, TT>::cell_iterator cell) {
     cell->value.reset();
     wasted_.splice(wasted_.end(), used_, cell);
+    update_sizes();
 }
 
-template <class T>
-bool storage<T>::is_valid(typename storage<T>::const_cell_iterator cell) const {
+template <class T, class TT>
+bool storage<T, TT>::is_valid(typename storage<T, TT>::const_cell_iterator cell) const {
     if (cell->waste_on_recycle) {
         return false;
     }
-    const auto now = time_traits::now();
+    const auto now = TT::now();
     const auto life_end = time_traits::add(cell->reset_time, lifespan_);
     if (life_end <= now) {
         return false;
@@ -153,12 +232,26 @@ bool storage<T>::is_valid(typename storage<T>::const_cell_iterator cell) const {
     return true;
 }
 
-template <class T>
-void storage<T>::invalidate() {
+template <class T, class TT>
+bool storage<T, TT>::validate(typename storage<T, TT>::cell_iterator cell) {
+    if (cell->waste_on_recycle) {
+        ++counters_.invalidated_recycles;
+        return false;
+    }
+    if (!is_valid(cell)) {
+        ++counters_.lifespan_expirations;
+        return false;
+    }
+    return true;
+}
+
+template <class T, class TT>
+void storage<T, TT>::invalidate() {
     for (auto& cell : available_) {
         cell.value.reset();
     }
     wasted_.splice(wasted_.end(), available_, available_.begin(), available_.end());
+    update_sizes();
     for (auto& cell : used_) {
         cell.waste_on_recycle = true;
     }
@@ -0,0 +1,140 @@
+#ifndef YAMAIL_RESOURCE_POOL_HISTOGRAM_HPP
+#define YAMAIL_RESOURCE_POOL_HISTOGRAM_HPP
+
+#include <yamail/resource_pool/time_traits.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace yamail {
+namespace resource_pool {
+
+class histogram_snapshot {
+public:
+    static constexpr std::size_t sub_buckets = 4;
+    static constexpr std::size_t max_power = 40;
+    static constexpr std::size_t buckets_count = sub_buckets + (max_power - 1) * sub_buckets + 1;
+
+    using buckets_type = std::array<std::uint64_t, buckets_count>;
+
+    histogram_snapshot() = default;
+
+    histogram_snapshot(const buckets_type& buckets, std::uint64_t sum, std::uint64_t max)
+            : buckets_(buckets), sum_(sum), max_(max) {
+        for (const auto value : buckets_) {
+            count_ += value;
+        }
+    }
+
+    std::uint64_t count() const noexcept { return count_; }
+    time_traits::duration sum() const noexcept { return from_nanoseconds(sum_); }
+    time_traits::duration max() const noexcept { return from_nanoseconds(max_); }
+    const buckets_type& buckets() const noexcept { return buckets_; }
+
+    time_traits::duration percentile(double value) const noexcept {
+        if (count_ == 0) {
+            return time_traits::duration::zero();
+        }
+        const auto rank = std::max(std::uint64_t(1),
+            static_cast<std::uint64_t>(std::ceil(value * static_cast<double>(count_))));
+        std::uint64_t accumulated = 0;
+        for (std::size_t i = 0; i < buckets_.size(); ++i) {
+            accumulated += buckets_[i];
+            if (accumulated >= rank) {
+                return std::min(upper_bound(i), max());
+            }
+        }
+        return max();
+    }
+
+    static std::size_t bucket(std::uint64_t nanoseconds) noexcept {
+        if (nanoseconds < sub_buckets) {
+            return static_cast<std::size_t>(nanoseconds);
+        }
+        const auto power = static_cast<std::size_t>(63 - __builtin_clzll(nanoseconds));
+        if (power >= max_power + 1) {
+            return buckets_count - 1;
+        }
+        const auto sub = static_cast<std::size_t>(nanoseconds >> (power - 2)) & (sub_buckets - 1);
+        return sub_buckets + (power - 2) * sub_buckets + sub;
+    }
+
+    static time_traits::duration upper_bound(std::size_t bucket) noexcept {
+        if (bucket < sub_buckets) {
+            return from_nanoseconds(bucket + 1);
+        }
+        if (bucket >= buckets_count - 1) {
+            return time_traits::duration::max();
+        }
+        const auto power = (bucket - sub_buckets) / sub_buckets + 2;
+        const auto sub = (bucket - sub_buckets) % sub_buckets;
+        return from_nanoseconds((std::uint64_t(sub_buckets + sub + 1)) << (power - 2));
+    }
+
+private:
+    buckets_type buckets_ {};
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    std::uint64_t max_ = 0;
+
+    static time_traits::duration from_nanoseconds(std::uint64_t value) noexcept {
+        return std::chrono::duration_cast<time_traits::duration>(std::chrono::nanoseconds(value));
+    }
+};
+
+class histogram {
+public:
+    histogram() = default;
+    histogram(const histogram&) = delete;
+    histogram& operator =(const histogram&) = delete;
+
+    void record(time_traits::duration value) noexcept {
+        const auto nanoseconds = static_cast<std::uint64_t>(std::max(std::int64_t(0), static_cast<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(value).count())));
+        buckets_[histogram_snapshot::bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+        auto max = max_.load(std::memory_order_relaxed);
+        while (max < nanoseconds && !max_.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {}
+    }
+
+    histogram_snapshot snapshot() const noexcept {
+        histogram_snapshot::buckets_type buckets;
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        return histogram_snapshot(buckets, sum_.load(std::memory_order_relaxed), max_.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, histogram_snapshot::buckets_count> buckets_ {};
+    std::atomic<std::uint64_t> sum_ {0};
+    std::atomic<std::uint64_t> max_ {0};
+};
+
+struct latency_stats {
+    histogram_snapshot wait;
+    histogram_snapshot acquire;
+    histogram_snapshot hold;
+};
+
+namespace detail {
+
+struct pool_latency {
+    histogram wait;
+    histogram acquire;
+    histogram hold;
+
+    latency_stats snapshot() const noexcept {
+        return latency_stats {wait.snapshot(), acquire.snapshot(), hold.snapshot()};
+    }
+};
+
+} // namespace detail
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_HISTOGRAM_HPP
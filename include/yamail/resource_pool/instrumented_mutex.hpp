@@ -0,0 +1,101 @@
+#ifndef YAMAIL_RESOURCE_POOL_INSTRUMENTED_MUTEX_HPP
+#define YAMAIL_RESOURCE_POOL_INSTRUMENTED_MUTEX_HPP
+
+#include <yamail/resource_pool/time_traits.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+namespace yamail {
+namespace resource_pool {
+
+struct mutex_stats {
+    std::uint64_t acquisitions = 0;
+    std::uint64_t contended = 0;
+    time_traits::duration wait_time = time_traits::duration::zero();
+    time_traits::duration hold_time = time_traits::duration::zero();
+};
+
+template <class Mutex = std::mutex>
+class instrumented_mutex {
+public:
+    using mutex_type = Mutex;
+
+    instrumented_mutex() = default;
+    instrumented_mutex(const instrumented_mutex&) = delete;
+    instrumented_mutex& operator =(const instrumented_mutex&) = delete;
+
+    void lock() {
+        if (mutex_.try_lock()) {
+            acquired_at_ = time_traits::now();
+            acquisitions_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const auto start = time_traits::now();
+        mutex_.lock();
+        acquired_at_ = time_traits::now();
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+        contended_.fetch_add(1, std::memory_order_relaxed);
+        wait_time_.fetch_add((acquired_at_ - start).count(), std::memory_order_relaxed);
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) {
+            return false;
+        }
+        acquired_at_ = time_traits::now();
+        acquisitions_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock() {
+        hold_time_.fetch_add((time_traits::now() - acquired_at_).count(), std::memory_order_relaxed);
+        mutex_.unlock();
+    }
+
+    mutex_stats stats() const noexcept {
+        mutex_stats result;
+        result.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+        result.contended = contended_.load(std::memory_order_relaxed);
+        result.wait_time = time_traits::duration(wait_time_.load(std::memory_order_relaxed));
+        result.hold_time = time_traits::duration(hold_time_.load(std::memory_order_relaxed));
+        return result;
+    }
+
+private:
+    using rep = time_traits::duration::rep;
+
+    mutex_type mutex_;
+    time_traits::time_point acquired_at_;
+    std::atomic<std::uint64_t> acquisitions_ {0};
+    std::atomic<std::uint64_t> contended_ {0};
+    std::atomic<rep> wait_time_ {0};
+    std::atomic<rep> hold_time_ {0};
+};
+
+namespace detail {
+
+template <class Mutex, class = void>
+struct has_mutex_stats : std::false_type {};
+
+template <class Mutex>
+struct has_mutex_stats<Mutex, std::void_t<decltype(std::declval<const Mutex&>().stats())>> : std::true_type {};
+
+template <class Mutex>
+mutex_stats get_mutex_stats(const Mutex& mutex) noexcept {
+    if constexpr (has_mutex_stats<Mutex>::value) {
+        return mutex.stats();
+    } else {
+        static_cast<void>(mutex);
+        return mutex_stats {};
+    }
+}
+
+} // namespace detail
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_INSTRUMENTED_MUTEX_HPP
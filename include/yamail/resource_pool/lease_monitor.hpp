@@ -0,0 +1,159 @@
+#ifndef YAMAIL_RESOURCE_POOL_LEASE_MONITOR_HPP
+#define YAMAIL_RESOURCE_POOL_LEASE_MONITOR_HPP
+
+#include <yamail/resource_pool/call_site.hpp>
+#include <yamail/resource_pool/time_traits.hpp>
+#include <yamail/resource_pool/detail/idle.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace yamail {
+namespace resource_pool {
+
+struct lease_info {
+    time_traits::duration held;
+    call_site site;
+};
+
+struct lease_monitor_stats {
+    std::uint64_t checks = 0;
+    std::uint64_t overdue_leases = 0;
+    std::size_t overdue = 0;
+};
+
+// Holds pool implementation weakly, checks stop when it is destroyed.
+template <class PoolImpl, class Timer = typename PoolImpl::time_traits_type::timer>
+class lease_monitor : public std::enable_shared_from_this<lease_monitor<PoolImpl, Timer>> {
+public:
+    using pool_impl = PoolImpl;
+    using time_traits_type = typename pool_impl::time_traits_type;
+    using timer_t = Timer;
+    using callback = std::function<void (const lease_info&)>;
+
+    template <class IoContext>
+    lease_monitor(IoContext& io_context,
+                  std::weak_ptr<const pool_impl> impl,
+                  time_traits::duration max_lease_duration,
+                  time_traits::duration check_interval,
+                  callback on_overdue)
+            : _impl(std::move(impl)),
+              _max_lease_duration(max_lease_duration),
+              _check_interval(check_interval),
+              _on_overdue(std::move(on_overdue)),
+              _timer(io_context) {}
+
+    lease_monitor(const lease_monitor&) = delete;
+    lease_monitor(lease_monitor&&) = delete;
+
+    time_traits::duration max_lease_duration() const noexcept { return _max_lease_duration; }
+    time_traits::duration check_interval() const noexcept { return _check_interval; }
+
+    lease_monitor_stats stats() const noexcept;
+
+    void start();
+    void stop();
+    std::size_t check(time_traits::time_point now = time_traits_type::now());
+
+private:
+    const std::weak_ptr<const pool_impl> _impl;
+    const time_traits::duration _max_lease_duration;
+    const time_traits::duration _check_interval;
+    const callback _on_overdue;
+    timer_t _timer;
+    std::mutex _check_mutex;
+    time_traits::time_point _last_check = time_traits::time_point::min();
+    std::vector<lease_info> _reported;
+    std::atomic<std::uint64_t> _checks {0};
+    std::atomic<std::uint64_t> _overdue_leases {0};
+    std::atomic<std::size_t> _overdue {0};
+
+    void schedule();
+};
+
+template <class P, class T>
+lease_monitor_stats lease_monitor<P, T>::stats() const noexcept {
+    lease_monitor_stats result;
+    result.checks = _checks.load(std::memory_order_relaxed);
+    result.overdue_leases = _overdue_leases.load(std::memory_order_relaxed);
+    result.overdue = _overdue.load(std::memory_order_relaxed);
+    return result;
+}
+
+template <class P, class T>
+void lease_monitor<P, T>::start() {
+    schedule();
+}
+
+template <class P, class T>
+void lease_monitor<P, T>::stop() {
+    _timer.cancel();
+}
+
+template <class P, class T>
+std::size_t lease_monitor<P, T>::check(time_traits::time_point now) {
+    const auto impl = _impl.lock();
+    if (!impl) {
+        return 0;
+    }
+    const std::lock_guard<std::mutex> lock(_check_mutex);
+    std::size_t overdue = 0;
+    _reported.clear();
+    impl->for_each_lease([&] (const auto& cell) {
+        const auto deadline = time_traits_type::add(cell.lease_time, _max_lease_duration);
+        if (deadline > now) {
+            return;
+        }
+        ++overdue;
+        if (deadline > _last_check) {
+            _reported.push_back(lease_info {now - cell.lease_time, detail::get_lease_site(cell)});
+        }
+    });
+    _last_check = now;
+    _checks.fetch_add(1, std::memory_order_relaxed);
+    _overdue_leases.fetch_add(_reported.size(), std::memory_order_relaxed);
+    _overdue.store(overdue, std::memory_order_relaxed);
+    if (_on_overdue) {
+        for (const auto& info : _reported) {
+            _on_overdue(info);
+        }
+    }
+    return _reported.size();
+}
+
+template <class P, class T>
+void lease_monitor<P, T>::schedule() {
+    _timer.expires_at(time_traits_type::add(time_traits_type::now(), _check_interval));
+    std::weak_ptr<lease_monitor> weak(this->shared_from_this());
+    _timer.async_wait([weak] (boost::system::error_code ec) {
+        if (ec) {
+            return;
+        }
+        const auto locked = weak.lock();
+        if (!locked || locked->_impl.expired()) {
+            return;
+        }
+        locked->check();
+        locked->schedule();
+    });
+}
+
+template <class Pool, class IoContext, class Callback>
+auto make_lease_monitor(IoContext& io_context,
+                        const Pool& pool,
+                        time_traits::duration max_lease_duration,
+                        time_traits::duration check_interval,
+                        Callback&& on_overdue) {
+    using monitor = lease_monitor<typename Pool::pool_impl>;
+    return std::make_shared<monitor>(io_context, pool.shared_impl(), max_lease_duration, check_interval,
+                                     std::forward<Callback>(on_overdue));
+}
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_LEASE_MONITOR_HPP
@@ -0,0 +1,38 @@
+#ifndef YAMAIL_RESOURCE_POOL_MEMORY_USAGE_HPP
+#define YAMAIL_RESOURCE_POOL_MEMORY_USAGE_HPP
+
+#include <cstddef>
+
+namespace yamail {
+namespace resource_pool {
+
+// Bytes requested from allocator by pool internals. Allocator overhead and memory owned by values are not counted.
+struct memory_usage {
+    std::size_t pool = 0;
+    std::size_t cells = 0;
+    std::size_t queue_nodes = 0;
+    std::size_t timers = 0;
+    std::size_t handlers = 0;
+    std::size_t queued = 0;
+    std::size_t free_queue_nodes = 0;
+
+    std::size_t total() const noexcept {
+        return pool + cells + queue_nodes + timers + handlers;
+    }
+};
+
+namespace detail {
+
+template <class T>
+constexpr std::size_t list_node_size = sizeof(T) + 2 * sizeof(void*);
+
+// Next link and cached hash.
+template <class T>
+constexpr std::size_t hash_node_size = sizeof(T) + 2 * sizeof(void*);
+
+} // namespace detail
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_MEMORY_USAGE_HPP
@@ -0,0 +1,126 @@
+#ifndef YAMAIL_RESOURCE_POOL_NUMA_TOPOLOGY_HPP
+#define YAMAIL_RESOURCE_POOL_NUMA_TOPOLOGY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace yamail {
+namespace resource_pool {
+
+// Nodes are indexed densely in order of their ids, so node ids without CPUs don't get an index.
+class numa_topology {
+public:
+    numa_topology() : numa_topology(read_cpu_nodes()) {}
+
+    inline explicit numa_topology(std::vector<std::size_t> cpu_nodes);
+
+    std::size_t nodes() const noexcept { return node_ids_.size(); }
+
+    const std::vector<std::size_t>& node_ids() const noexcept { return node_ids_; }
+
+    std::size_t node(std::size_t cpu) const noexcept {
+        return cpu < cpu_nodes_.size() ? cpu_nodes_[cpu] : node_ids_.front();
+    }
+
+    std::size_t node_index(std::size_t cpu) const noexcept {
+        return cpu < cpu_indices_.size() ? cpu_indices_[cpu] : 0;
+    }
+
+    std::size_t current_node() const noexcept {
+        return node_index(current_cpu());
+    }
+
+    static std::size_t current_cpu() noexcept {
+#ifdef __linux__
+        const int cpu = sched_getcpu();
+        return cpu < 0 ? 0 : static_cast<std::size_t>(cpu);
+#else
+        return 0;
+#endif
+    }
+
+    static std::vector<std::size_t> parse_list(const std::string& value);
+
+    static std::vector<std::size_t> read_cpu_nodes(const std::string& sysfs_node_path = "/sys/devices/system/node");
+
+private:
+    std::vector<std::size_t> cpu_nodes_;
+    std::vector<std::size_t> node_ids_;
+    std::vector<std::size_t> cpu_indices_;
+};
+
+numa_topology::numa_topology(std::vector<std::size_t> cpu_nodes)
+        : cpu_nodes_(std::move(cpu_nodes)), node_ids_(cpu_nodes_) {
+    std::sort(node_ids_.begin(), node_ids_.end());
+    node_ids_.erase(std::unique(node_ids_.begin(), node_ids_.end()), node_ids_.end());
+    if (node_ids_.empty()) {
+        node_ids_.push_back(0);
+    }
+    cpu_indices_.reserve(cpu_nodes_.size());
+    for (const auto node : cpu_nodes_) {
+        const auto it = std::lower_bound(node_ids_.begin(), node_ids_.end(), node);
+        cpu_indices_.push_back(static_cast<std::size_t>(it - node_ids_.begin()));
+    }
+}
+
+inline std::vector<std::size_t> numa_topology::parse_list(const std::string& value) {
+    std::vector<std::size_t> result;
+    std::size_t pos = 0;
+    while (pos < value.size()) {
+        const auto end = std::min(value.find(',', pos), value.size());
+        const auto range = value.substr(pos, end - pos);
+        pos = end + 1;
+        const auto dash = range.find('-');
+        try {
+            const auto first = std::stoul(range.substr(0, dash));
+            const auto last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (auto i = first; i <= last; ++i) {
+                result.push_back(i);
+            }
+        } catch (const std::logic_error&) {
+            continue;
+        }
+    }
+    return result;
+}
+
+inline std::vector<std::size_t> numa_topology::read_cpu_nodes(const std::string& sysfs_node_path) {
+    constexpr auto unknown = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> result;
+    std::string nodes;
+    if (!std::getline(std::ifstream(sysfs_node_path + "/possible"), nodes)) {
+        return result;
+    }
+    for (const auto node : parse_list(nodes)) {
+        std::string cpus;
+        if (!std::getline(std::ifstream(sysfs_node_path + "/node" + std::to_string(node) + "/cpulist"), cpus)) {
+            continue;
+        }
+        for (const auto cpu : parse_list(cpus)) {
+            if (cpu >= result.size()) {
+                result.resize(cpu + 1, unknown);
+            }
+            result[cpu] = node;
+        }
+    }
+    const auto first_node = std::min_element(result.begin(), result.end());
+    if (first_node == result.end() || *first_node == unknown) {
+        return {};
+    }
+    std::replace(result.begin(), result.end(), unknown, std::size_t(*first_node));
+    return result;
+}
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_NUMA_TOPOLOGY_HPP
@@ -0,0 +1,22 @@
+#ifndef YAMAIL_RESOURCE_POOL_OBSERVER_HPP
+#define YAMAIL_RESOURCE_POOL_OBSERVER_HPP
+
+#include <yamail/resource_pool/time_traits.hpp>
+
+namespace yamail {
+namespace resource_pool {
+
+struct null_observer {
+    static void lease(time_traits::duration /*acquire*/) noexcept {}
+    static void recycle(time_traits::duration /*hold*/) noexcept {}
+    static void waste(time_traits::duration /*hold*/) noexcept {}
+    static void enqueue() noexcept {}
+    static void dequeue(time_traits::duration /*wait*/) noexcept {}
+    static void expire(time_traits::duration /*wait*/) noexcept {}
+    static void overflow() noexcept {}
+};
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_OBSERVER_HPP
@@ -0,0 +1,280 @@
+#ifndef YAMAIL_RESOURCE_POOL_OPENMETRICS_HPP
+#define YAMAIL_RESOURCE_POOL_OPENMETRICS_HPP
+
+#include <yamail/resource_pool/counters.hpp>
+#include <yamail/resource_pool/histogram.hpp>
+#include <yamail/resource_pool/instrumented_mutex.hpp>
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace yamail {
+namespace resource_pool {
+namespace openmetrics {
+
+struct pool_snapshot {
+    std::string_view name;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t available = 0;
+    std::size_t used = 0;
+    boost::optional<std::size_t> queue_size;
+    pool_counters counters;
+    latency_stats latency;
+    mutex_stats mutex;
+    boost::optional<mutex_stats> queue_mutex;
+};
+
+template <class Pool>
+struct named_pool {
+    std::string_view name;
+    const Pool& pool;
+};
+
+template <class Pool>
+named_pool<Pool> named(std::string_view name, const Pool& pool) {
+    return named_pool<Pool> {name, pool};
+}
+
+namespace detail {
+
+template <class Stats, class = void>
+struct has_queue : std::false_type {};
+
+template <class Stats>
+struct has_queue<Stats, std::void_t<decltype(std::declval<const Stats&>().queue_mutex)>> : std::true_type {};
+
+class writer {
+public:
+    writer(char* data, std::size_t size) : begin_(data), pos_(data), end_(data + size) {}
+
+    bool overflow() const noexcept { return overflow_; }
+
+    std::string_view result() const noexcept {
+        return overflow_ ? std::string_view() : std::string_view(begin_, static_cast<std::size_t>(pos_ - begin_));
+    }
+
+    writer& operator <<(std::string_view value) noexcept {
+        if (overflow_ || static_cast<std::size_t>(end_ - pos_) < value.size()) {
+            overflow_ = true;
+            return *this;
+        }
+        std::memcpy(pos_, value.data(), value.size());
+        pos_ += value.size();
+        return *this;
+    }
+
+    writer& operator <<(char value) noexcept {
+        return *this << std::string_view(&value, 1);
+    }
+
+    writer& operator <<(std::uint64_t value) noexcept {
+        return write_number(value);
+    }
+
+    writer& operator <<(double value) noexcept {
+        return write_number(value);
+    }
+
+    writer& label_value(std::string_view value) noexcept {
+        for (const char c : value) {
+            switch (c) {
+                case '\\': *this << "\\\\"; break;
+                case '"': *this << "\\\""; break;
+                case '\n': *this << "\\n"; break;
+                default: *this << c;
+            }
+        }
+        return *this;
+    }
+
+private:
+    char* begin_;
+    char* pos_;
+    char* end_;
+    bool overflow_ = false;
+
+    template <class T>
+    writer& write_number(T value) noexcept {
+        if (overflow_) {
+            return *this;
+        }
+        const auto result = std::to_chars(pos_, end_, value);
+        if (result.ec != std::errc()) {
+            overflow_ = true;
+            return *this;
+        }
+        pos_ = result.ptr;
+        return *this;
+    }
+};
+
+inline double seconds(time_traits::duration value) noexcept {
+    return std::chrono::duration<double>(value).count();
+}
+
+inline void family(writer& out, std::string_view name, std::string_view type, std::string_view help) {
+    out << "# TYPE resource_pool_" << name << ' ' << type << '\n'
+        << "# HELP resource_pool_" << name << ' ' << help << '\n';
+}
+
+inline void sample_begin(writer& out, std::string_view name, std::string_view suffix, const pool_snapshot& pool) {
+    out << "resource_pool_" << name << suffix << "{pool=\"";
+    out.label_value(pool.name) << '"';
+}
+
+template <class Value>
+void sample(writer& out, std::string_view name, std::string_view suffix, const pool_snapshot& pool, Value value) {
+    sample_begin(out, name, suffix, pool);
+    out << "} " << value << '\n';
+}
+
+template <class Value>
+void sample(writer& out, std::string_view name, std::string_view suffix, const pool_snapshot& pool,
+        std::string_view label, std::string_view label_value, Value value) {
+    sample_begin(out, name, suffix, pool);
+    out << ',' << label << "=\"" << label_value << "\"} " << value << '\n';
+}
+
+template <class Getter>
+void gauge(writer& out, std::string_view name, std::string_view help,
+        const pool_snapshot* begin, const pool_snapshot* end, Getter getter) {
+    family(out, name, "gauge", help);
+    for (auto pool = begin; pool != end; ++pool) {
+        if (const auto value = getter(*pool)) {
+            sample(out, name, "", *pool, std::uint64_t(*value));
+        }
+    }
+}
+
+inline void histogram(writer& out, std::string_view name, std::string_view help,
+        const pool_snapshot* begin, const pool_snapshot* end, histogram_snapshot latency_stats::*member) {
+    family(out, name, "histogram", help);
+    for (auto pool = begin; pool != end; ++pool) {
+        const auto& snapshot = pool->latency.*member;
+        const auto& buckets = snapshot.buckets();
+        std::uint64_t accumulated = 0;
+        for (std::size_t i = 0; i + 1 < buckets.size(); ++i) {
+            accumulated += buckets[i];
+            const auto bound = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                histogram_snapshot::upper_bound(i)).count();
+            if ((bound & (bound - 1)) != 0 || bound < 1024) {
+                continue;
+            }
+            // Bucket upper bound is exclusive while le is inclusive, so emit the last nanosecond of the bucket.
+            sample_begin(out, name, "_bucket", *pool);
+            out << ",le=\"" << seconds(histogram_snapshot::upper_bound(i) - std::chrono::nanoseconds(1)) << "\"} "
+                << accumulated << '\n';
+        }
+        sample(out, name, "_bucket", *pool, "le", "+Inf", snapshot.count());
+        sample(out, name, "_count", *pool, snapshot.count());
+        sample(out, name, "_sum", *pool, seconds(snapshot.sum()));
+    }
+}
+
+} // namespace detail
+
+template <class Pool>
+pool_snapshot make_snapshot(std::string_view name, const Pool& pool) {
+    const auto stats = pool.stats();
+    pool_snapshot result;
+    result.name = name;
+    result.capacity = pool.capacity();
+    result.size = stats.size;
+    result.available = stats.available;
+    result.used = stats.used;
+    result.counters = stats.counters;
+    result.latency = pool.latency();
+    result.mutex = stats.mutex;
+    if constexpr (detail::has_queue<std::decay_t<decltype(stats)>>::value) {
+        result.queue_size = stats.queue_size;
+        result.queue_mutex = stats.queue_mutex;
+    }
+    return result;
+}
+
+inline std::string_view write(char* data, std::size_t size, const pool_snapshot* begin, const pool_snapshot* end) {
+    using detail::gauge;
+    using detail::sample;
+    using detail::seconds;
+    using optional_size = boost::optional<std::size_t>;
+
+    detail::writer out(data, size);
+
+    gauge(out, "capacity", "Maximum number of resources.", begin, end,
+        [] (const pool_snapshot& v) { return optional_size(v.capacity); });
+    gauge(out, "size", "Number of available and used resources.", begin, end,
+        [] (const pool_snapshot& v) { return optional_size(v.size); });
+    gauge(out, "available", "Number of idle resources.", begin, end,
+        [] (const pool_snapshot& v) { return optional_size(v.available); });
+    gauge(out, "used", "Number of leased resources.", begin, end,
+        [] (const pool_snapshot& v) { return optional_size(v.used); });
+    gauge(out, "queue_size", "Number of waiting requests.", begin, end,
+        [] (const pool_snapshot& v) { return v.queue_size; });
+
+    detail::family(out, "leases", "counter", "Number of leases by kind of leased cell.");
+    for (auto pool = begin; pool != end; ++pool) {
+        sample(out, "leases", "_total", *pool, "kind", "idle", pool->counters.idle_leases);
+        sample(out, "leases", "_total", *pool, "kind", "empty", pool->counters.empty_leases);
+    }
+
+    detail::family(out, "expirations", "counter", "Number of dropped expired resources.");
+    for (auto pool = begin; pool != end; ++pool) {
+        sample(out, "expirations", "_total", *pool, "reason", "idle_timeout", pool->counters.idle_timeout_expirations);
+        sample(out, "expirations", "_total", *pool, "reason", "lifespan", pool->counters.lifespan_expirations);
+    }
+
+    detail::family(out, "invalidated_recycles", "counter", "Number of recycled resources wasted after invalidate.");
+    for (auto pool = begin; pool != end; ++pool) {
+        sample(out, "invalidated_recycles", "_total", *pool, pool->counters.invalidated_recycles);
+    }
+
+    detail::family(out, "errors", "counter", "Number of failed get requests.");
+    for (auto pool = begin; pool != end; ++pool) {
+        sample(out, "errors", "_total", *pool, "error", "get_resource_timeout", pool->counters.get_resource_timeouts);
+        sample(out, "errors", "_total", *pool, "error", "request_queue_overflow", pool->counters.request_queue_overflows);
+        sample(out, "errors", "_total", *pool, "error", "disabled", pool->counters.disabled);
+    }
+
+    const auto mutex_counter = [&] (std::string_view name, std::string_view help, auto member) {
+        detail::family(out, name, "counter", help);
+        for (auto pool = begin; pool != end; ++pool) {
+            sample(out, name, "_total", *pool, "mutex", "pool", member(pool->mutex));
+            if (pool->queue_mutex) {
+                sample(out, name, "_total", *pool, "mutex", "queue", member(*pool->queue_mutex));
+            }
+        }
+    };
+    mutex_counter("mutex_acquisitions", "Number of mutex acquisitions.",
+        [] (const mutex_stats& v) { return v.acquisitions; });
+    mutex_counter("mutex_contended_acquisitions", "Number of mutex acquisitions which had to wait.",
+        [] (const mutex_stats& v) { return v.contended; });
+    mutex_counter("mutex_wait_seconds", "Time spent waiting for mutex.",
+        [] (const mutex_stats& v) { return seconds(v.wait_time); });
+    mutex_counter("mutex_hold_seconds", "Time mutex was held.",
+        [] (const mutex_stats& v) { return seconds(v.hold_time); });
+
+    detail::histogram(out, "wait_seconds", "Time spent by request in queue.", begin, end, &latency_stats::wait);
+    detail::histogram(out, "acquire_seconds", "Time from get call to lease.", begin, end, &latency_stats::acquire);
+    detail::histogram(out, "hold_seconds", "Time from lease to return.", begin, end, &latency_stats::hold);
+
+    out << "# EOF\n";
+    return out.result();
+}
+
+template <class ... Pools>
+std::string_view write(char* data, std::size_t size, const named_pool<Pools>& ... pools) {
+    const std::array<pool_snapshot, sizeof ... (Pools)> snapshots {{make_snapshot(pools.name, pools.pool) ...}};
+    return write(data, size, snapshots.data(), snapshots.data() + snapshots.size());
+}
+
+} // namespace openmetrics
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_OPENMETRICS_HPP
@@ -0,0 +1,328 @@
+#ifndef YAMAIL_RESOURCE_POOL_SYNC_DETAIL_FAIR_POOL_IMPL_HPP
+#define YAMAIL_RESOURCE_POOL_SYNC_DETAIL_FAIR_POOL_IMPL_HPP
+
+#include <yamail/resource_pool/sync/detail/pool_impl.hpp>
+
+#include <boost/intrusive/list.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace yamail {
+namespace resource_pool {
+namespace sync {
+namespace detail {
+
+template <class Value, class Mutex, class ConditionVariable, class Observer = null_observer>
+class fair_pool_impl : public pool_returns<Value> {
+public:
+    using value_type = Value;
+    using condition_variable = ConditionVariable;
+    using observer_type = Observer;
+    using idle = resource_pool::detail::idle<value_type>;
+    using storage_type = resource_pool::detail::storage<value_type>;
+    using list_iterator = typename storage_type::cell_iterator;
+    using time_traits_type = time_traits;
+    using get_result = std::pair<boost::system::error_code, list_iterator>;
+
+    fair_pool_impl(std::size_t capacity,
+                   time_traits::duration idle_timeout,
+                   time_traits::duration lifespan,
+                   sync::adaptive_wait wait = sync::adaptive_wait())
+            : storage_(assert_capacity(capacity), idle_timeout, lifespan),
+              _capacity(capacity),
+              _wait(wait) {
+    }
+
+    template <class Generator>
+    fair_pool_impl(Generator&& gen_value,
+                   std::size_t capacity,
+                   time_traits::duration idle_timeout,
+                   time_traits::duration lifespan,
+                   sync::adaptive_wait wait = sync::adaptive_wait())
+            : storage_(std::forward<Generator>(gen_value), assert_capacity(capacity), idle_timeout, lifespan),
+              _capacity(capacity),
+              _wait(wait) {
+    }
+
+    fair_pool_impl(const fair_pool_impl&) = delete;
+
+    fair_pool_impl(fair_pool_impl&&) = delete;
+
+    std::size_t capacity() const { return _capacity; }
+    const sync::adaptive_wait& wait() const { return _wait; }
+    std::size_t size() const;
+    std::size_t available() const;
+    std::size_t used() const;
+    std::size_t queue_size() const;
+    sync::stats stats() const;
+    latency_stats latency() const { return _latency.snapshot(); }
+    resource_pool::memory_usage memory_usage() const;
+
+    get_result get(time_traits::duration wait_duration = time_traits::duration(0));
+    void recycle(list_iterator res_it) final;
+    void waste(list_iterator res_it) final;
+    void disable();
+    void invalidate();
+
+    template <class Function>
+    void for_each_lease(Function&& function) const {
+        const lock_guard lock(_mutex);
+        storage_.for_each_used(function);
+    }
+
+    static std::size_t assert_capacity(std::size_t value);
+
+private:
+    using mutex_t = Mutex;
+    using lock_guard = std::lock_guard<mutex_t>;
+    using unique_lock = std::unique_lock<mutex_t>;
+
+    // Lives on waiting thread stack. Served waiter is notified after unlock, so it waits for notifying to be reset
+    // before return.
+    struct waiter : boost::intrusive::list_base_hook<> {
+        condition_variable ready;
+        boost::optional<list_iterator> cell;
+        bool disabled = false;
+        std::atomic<bool> served {false};
+        std::atomic<bool> notifying {false};
+    };
+
+    using waiters_list = boost::intrusive::list<waiter>;
+
+    mutable mutex_t _mutex;
+    storage_type storage_;
+    const std::size_t _capacity;
+    const sync::adaptive_wait _wait;
+    waiters_list _waiters;
+    resource_pool::detail::relaxed_value<std::size_t> _queue_size;
+    bool _disabled = false;
+    resource_pool::detail::pool_latency _latency;
+    resource_pool::detail::error_counters _errors;
+
+    waiter* serve_waiter();
+    static void mark_served(waiter& value);
+    static void notify(waiter* value);
+    static void wait_notified(const waiter& value);
+    get_result acquired(list_iterator cell, time_traits::time_point start, bool waited);
+};
+
+template <class T, class M, class C, class O>
+std::size_t fair_pool_impl<T, M, C, O>::size() const {
+    const auto stats = storage_.stats();
+    return stats.available + stats.used;
+}
+
+template <class T, class M, class C, class O>
+std::size_t fair_pool_impl<T, M, C, O>::available() const {
+    return storage_.stats().available;
+}
+
+template <class T, class M, class C, class O>
+std::size_t fair_pool_impl<T, M, C, O>::used() const {
+    return storage_.stats().used;
+}
+
+template <class T, class M, class C, class O>
+std::size_t fair_pool_impl<T, M, C, O>::queue_size() const {
+    return _queue_size.load();
+}
+
+template <class T, class M, class C, class O>
+resource_pool::memory_usage fair_pool_impl<T, M, C, O>::memory_usage() const {
+    resource_pool::memory_usage result;
+    result.pool = sizeof(*this);
+    const lock_guard lock(_mutex);
+    result.cells = storage_.memory_usage();
+    return result;
+}
+
+template <class T, class M, class C, class O>
+sync::stats fair_pool_impl<T, M, C, O>::stats() const {
+    const auto stats = storage_.stats();
+    const auto counters = storage_.counters();
+    sync::stats result;
+    result.size = stats.available + stats.used;
+    result.available = stats.available;
+    result.used = stats.used;
+    result.counters = _errors.make_pool_counters(counters);
+    result.mutex = resource_pool::detail::get_mutex_stats(_mutex);
+    return result;
+}
+
+template <class T, class M, class C, class O>
+void fair_pool_impl<T, M, C, O>::recycle(list_iterator res_it) {
+    const auto hold = time_traits::now() - res_it->lease_time;
+    _latency.hold.record(hold);
+    observer_type::recycle(hold);
+    waiter* const served = [&] {
+        const lock_guard lock(_mutex);
+        storage_.recycle(res_it);
+        return serve_waiter();
+    } ();
+    notify(served);
+}
+
+template <class T, class M, class C, class O>
+void fair_pool_impl<T, M, C, O>::waste(list_iterator res_it) {
+    const auto hold = time_traits::now() - res_it->lease_time;
+    _latency.hold.record(hold);
+    observer_type::waste(hold);
+    waiter* const served = [&] {
+        const lock_guard lock(_mutex);
+        storage_.waste(res_it);
+        return serve_waiter();
+    } ();
+    notify(served);
+}
+
+template <class T, class M, class C, class O>
+void fair_pool_impl<T, M, C, O>::disable() {
+    waiters_list disabled;
+    {
+        const lock_guard lock(_mutex);
+        _disabled = true;
+        for (auto& value : _waiters) {
+            value.disabled = true;
+            mark_served(value);
+        }
+        disabled.splice(disabled.end(), _waiters);
+        _queue_size.store(0);
+    }
+    while (!disabled.empty()) {
+        waiter& head = disabled.front();
+        disabled.pop_front();
+        notify(&head);
+    }
+}
+
+template <class T, class M, class C, class O>
+typename fair_pool_impl<T, M, C, O>::get_result fair_pool_impl<T, M, C, O>::get(time_traits::duration wait_duration) {
+    const auto start = time_traits::now();
+    unique_lock lock(_mutex);
+    if (_disabled) {
+        lock.unlock();
+        _errors.count(error::disabled);
+        return std::make_pair(make_error_code(error::disabled), list_iterator());
+    }
+    if (_waiters.empty()) {
+        if (const auto cell = storage_.lease()) {
+            lock.unlock();
+            return acquired(*cell, start, false);
+        }
+    }
+    if (wait_duration.count() <= 0) {
+        lock.unlock();
+        _errors.count(error::get_resource_timeout);
+        return std::make_pair(make_error_code(error::get_resource_timeout), list_iterator());
+    }
+    waiter self;
+    _waiters.push_back(self);
+    _queue_size.store(_waiters.size());
+    observer_type::enqueue();
+    const auto deadline = time_traits::add(time_traits::now(), wait_duration);
+    if (_wait.spins > 0) {
+        lock.unlock();
+        resource_pool::detail::spin_until([&] { return self.served.load(std::memory_order_acquire); },
+            _wait.spins, _wait.max_pause);
+        lock.lock();
+    }
+    while (!self.cell && !self.disabled) {
+        if (deadline == time_traits::time_point::max()) {
+            self.ready.wait(lock);
+        } else if (self.ready.wait_until(lock, deadline) == std::cv_status::timeout) {
+            break;
+        }
+    }
+    if (self.cell) {
+        lock.unlock();
+        wait_notified(self);
+        return acquired(*self.cell, start, true);
+    }
+    if (self.disabled) {
+        lock.unlock();
+        wait_notified(self);
+        _errors.count(error::disabled);
+        return std::make_pair(make_error_code(error::disabled), list_iterator());
+    }
+    _waiters.erase(_waiters.iterator_to(self));
+    _queue_size.store(_waiters.size());
+    lock.unlock();
+    _errors.count(error::get_resource_timeout);
+    observer_type::expire(time_traits::now() - start);
+    return std::make_pair(make_error_code(error::get_resource_timeout), list_iterator());
+}
+
+template <class T, class M, class C, class O>
+void fair_pool_impl<T, M, C, O>::invalidate() {
+    const lock_guard lock(_mutex);
+    storage_.invalidate();
+}
+
+template <class T, class M, class C, class O>
+typename fair_pool_impl<T, M, C, O>::waiter* fair_pool_impl<T, M, C, O>::serve_waiter() {
+    if (_waiters.empty()) {
+        return nullptr;
+    }
+    const auto cell = storage_.lease();
+    if (!cell) {
+        return nullptr;
+    }
+    waiter& head = _waiters.front();
+    _waiters.pop_front();
+    _queue_size.store(_waiters.size());
+    head.cell = *cell;
+    mark_served(head);
+    return &head;
+}
+
+template <class T, class M, class C, class O>
+void fair_pool_impl<T, M, C, O>::mark_served(waiter& value) {
+    value.notifying.store(true, std::memory_order_relaxed);
+    value.served.store(true, std::memory_order_release);
+}
+
+template <class T, class M, class C, class O>
+void fair_pool_impl<T, M, C, O>::notify(waiter* value) {
+    if (value == nullptr) {
+        return;
+    }
+    value->ready.notify_one();
+    value->notifying.store(false, std::memory_order_release);
+}
+
+template <class T, class M, class C, class O>
+void fair_pool_impl<T, M, C, O>::wait_notified(const waiter& value) {
+    while (value.notifying.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+template <class T, class M, class C, class O>
+typename fair_pool_impl<T, M, C, O>::get_result fair_pool_impl<T, M, C, O>::acquired(list_iterator cell,
+        time_traits::time_point start, bool waited) {
+    const auto elapsed = cell->lease_time - start;
+    _latency.acquire.record(elapsed);
+    if (waited) {
+        _latency.wait.record(elapsed);
+        observer_type::dequeue(elapsed);
+    }
+    observer_type::lease(elapsed);
+    return std::make_pair(boost::system::error_code(), cell);
+}
+
+template <class T, class M, class C, class O>
+std::size_t fair_pool_impl<T, M, C, O>::assert_capacity(std::size_t value) {
+    if (value == 0) {
+        throw error::zero_pool_capacity();
+    }
+    return value;
+}
+
+}
+}
+}
+}
+
+#endif
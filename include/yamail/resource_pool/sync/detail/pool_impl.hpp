@@ -1,12 +1,19 @@
 #ifndef YAMAIL_RESOURCE_POOL_SYNC_DETAIL_POOL_IMPL_HPP
 #define YAMAIL_RESOURCE_POOL_SYNC_DETAIL_POOL_IMPL_HPP
 
+#include <yamail/resource_pool/counters.hpp>
 #include <yamail/resource_pool/error.hpp>
+#include <yamail/resource_pool/histogram.hpp>
+#include <yamail/resource_pool/instrumented_mutex.hpp>
+#include <yamail/resource_pool/memory_usage.hpp>
+#include <yamail/resource_pool/observer.hpp>
 #include <yamail/resource_pool/time_traits.hpp>
 #include <yamail/resource_pool/detail/idle.hpp>
 #include <yamail/resource_pool/detail/storage.hpp>
 #include <yamail/resource_pool/detail/pool_returns.hpp>
+#include <yamail/resource_pool/detail/spin.hpp>
 
+#include <atomic>
 #include <condition_variable>
 #include <list>
 #include <mutex>
@@ -19,41 +26,59 @@ struct stats {
     std::size_t size;
     std::size_t available;
     std::size_t used;
+    pool_counters counters {};
+    mutex_stats mutex {};
+};
+
+struct adaptive_wait {
+    std::size_t spins = 0;
+    std::size_t max_pause = 64;
 };
 
 namespace detail {
 
 using resource_pool::detail::pool_returns;
 
-template <class Value, class Mutex, class ConditionVariable>
+template <class Value, class Mutex, class ConditionVariable, class Observer = null_observer>
 class pool_impl : public pool_returns<Value> {
 public:
     using value_type = Value;
     using condition_variable = ConditionVariable;
+    using observer_type = Observer;
     using idle = resource_pool::detail::idle<value_type>;
     using storage_type = resource_pool::detail::storage<value_type>;
     using list_iterator = typename storage_type::cell_iterator;
+    using time_traits_type = time_traits;
     using get_result = std::pair<boost::system::error_code, list_iterator>;
 
-    pool_impl(std::size_t capacity, time_traits::duration idle_timeout, time_traits::duration lifespan)
+    pool_impl(std::size_t capacity,
+              time_traits::duration idle_timeout,
+              time_traits::duration lifespan,
+              sync::adaptive_wait wait = sync::adaptive_wait())
             : storage_(assert_capacity(capacity), idle_timeout, lifespan),
-              _capacity(capacity) {
+              _capacity(capacity),
+              _wait(wait) {
     }
 
     template <class Generator>
     pool_impl(Generator&& gen_value,
               std::size_t capacity,
               time_traits::duration idle_timeout,
-              time_traits::duration lifespan)
+              time_traits::duration lifespan,
+              sync::adaptive_wait wait = sync::adaptive_wait())
             : storage_(std::forward<Generator>(gen_value), assert_capacity(capacity), idle_timeout, lifespan),
-              _capacity(capacity) {
+              _capacity(capacity),
+              _wait(wait) {
     }
 
     std::size_t capacity() const { return _capacity; }
+    const sync::adaptive_wait& wait() const { return _wait; }
     std::size_t size() const;
     std::size_t available() const;
     std::size_t used() const;
     sync::stats stats() const;
+    latency_stats latency() const { return _latency.snapshot(); }
+    resource_pool::memory_usage memory_usage() const;
 
     const condition_variable& has_capacity() const { return _has_capacity; }
 
@@ -63,6 +88,12 @@ public:
     void disable();
     void invalidate();
 
+    template <class Function>
+    void for_each_lease(Function&& function) const {
+        const lock_guard lock(_mutex);
+        storage_.for_each_used(function);
+    }
+
     static std::size_t assert_capacity(std::size_t value);
 
 private:
@@ -75,98 +106,161 @@ private:
     const std::size_t _capacity;
     condition_variable _has_capacity;
     bool _disabled = false;
+    const sync::adaptive_wait _wait;
+    std::atomic<std::size_t> _releases {0};
+    std::size_t _waiters = 0;
+    resource_pool::detail::pool_latency _latency;
+    resource_pool::detail::error_counters _errors;
 
-    bool wait_for(unique_lock& lock, time_traits::duration wait_duration);
+    bool wait_until(unique_lock& lock, time_traits::time_point deadline);
 };
 
-template <class T, class M, class C>
-std::size_t pool_impl<T, M, C>::size() const {
-    const auto stats = [&] {
-        const lock_guard lock(_mutex);
-        return storage_.stats();
-    } ();
+template <class T, class M, class C, class O>
+std::size_t pool_impl<T, M, C, O>::size() const {
+    const auto stats = storage_.stats();
     return stats.available + stats.used;
 }
 
-template <class T, class M, class C>
-std::size_t pool_impl<T, M, C>::available() const {
-    const lock_guard lock(_mutex);
+template <class T, class M, class C, class O>
+std::size_t pool_impl<T, M, C, O>::available() const {
     return storage_.stats().available;
 }
 
-template <class T, class M, class C>
-std::size_t pool_impl<T, M, C>::used() const {
-    const lock_guard lock(_mutex);
+template <class T, class M, class C, class O>
+std::size_t pool_impl<T, M, C, O>::used() const {
     return storage_.stats().used;
 }
 
-template <class T, class M, class C>
-sync::stats pool_impl<T, M, C>::stats() const {
-    const auto stats = [&] {
-        const lock_guard lock(_mutex);
-        return storage_.stats();
-    } ();
+template <class T, class M, class C, class O>
+resource_pool::memory_usage pool_impl<T, M, C, O>::memory_usage() const {
+    resource_pool::memory_usage result;
+    result.pool = sizeof(*this);
+    const lock_guard lock(_mutex);
+    result.cells = storage_.memory_usage();
+    return result;
+}
+
+template <class T, class M, class C, class O>
+sync::stats pool_impl<T, M, C, O>::stats() const {
+    const auto stats = storage_.stats();
+    const auto counters = storage_.counters();
     sync::stats result;
     result.size = stats.available + stats.used;
     result.available = stats.available;
     result.used = stats.used;
+    result.counters = _errors.make_pool_counters(counters);
+    result.mutex = resource_pool::detail::get_mutex_stats(_mutex);
     return result;
 }
 
-template <class T, class M, class C>
-void pool_impl<T, M, C>::recycle(list_iterator res_it) {
-    const lock_guard lock(_mutex);
-    storage_.recycle(res_it);
-    _has_capacity.notify_one();
+template <class T, class M, class C, class O>
+void pool_impl<T, M, C, O>::recycle(list_iterator res_it) {
+    const auto hold = time_traits::now() - res_it->lease_time;
+    _latency.hold.record(hold);
+    observer_type::recycle(hold);
+    const bool has_waiters = [&] {
+        const lock_guard lock(_mutex);
+        storage_.recycle(res_it);
+        _releases.fetch_add(1, std::memory_order_release);
+        return _waiters > 0;
+    } ();
+    if (has_waiters) {
+        _has_capacity.notify_one();
+    }
 }
 
-template <class T, class M, class C>
-void pool_impl<T, M, C>::waste(list_iterator res_it) {
-    const lock_guard lock(_mutex);
-    storage_.waste(res_it);
-    _has_capacity.notify_one();
+template <class T, class M, class C, class O>
+void pool_impl<T, M, C, O>::waste(list_iterator res_it) {
+    const auto hold = time_traits::now() - res_it->lease_time;
+    _latency.hold.record(hold);
+    observer_type::waste(hold);
+    const bool has_waiters = [&] {
+        const lock_guard lock(_mutex);
+        storage_.waste(res_it);
+        _releases.fetch_add(1, std::memory_order_release);
+        return _waiters > 0;
+    } ();
+    if (has_waiters) {
+        _has_capacity.notify_one();
+    }
 }
 
-template <class T, class M, class C>
-void pool_impl<T, M, C>::disable() {
-    const lock_guard lock(_mutex);
-    _disabled = true;
-    _has_capacity.notify_all();
+template <class T, class M, class C, class O>
+void pool_impl<T, M, C, O>::disable() {
+    const bool has_waiters = [&] {
+        const lock_guard lock(_mutex);
+        _disabled = true;
+        _releases.fetch_add(1, std::memory_order_release);
+        return _waiters > 0;
+    } ();
+    if (has_waiters) {
+        _has_capacity.notify_all();
+    }
 }
 
-template <class T, class M, class C>
-typename pool_impl<T, M, C>::get_result pool_impl<T, M, C>::get(time_traits::duration wait_duration) {
+template <class T, class M, class C, class O>
+typename pool_impl<T, M, C, O>::get_result pool_impl<T, M, C, O>::get(time_traits::duration wait_duration) {
+    const auto start = time_traits::now();
+    const auto deadline = time_traits::add(start, wait_duration);
+    bool waited = false;
     unique_lock lock(_mutex);
     while (true) {
         if (_disabled) {
             lock.unlock();
+            _errors.count(error::disabled);
             return std::make_pair(make_error_code(error::disabled), list_iterator());
         } 
         if (const auto cell = storage_.lease()) {
             lock.unlock();
+            const auto elapsed = (*cell)->lease_time - start;
+            _latency.acquire.record(elapsed);
+            if (waited) {
+                _latency.wait.record(elapsed);
+                observer_type::dequeue(elapsed);
+            }
+            observer_type::lease(elapsed);
             return std::make_pair(boost::system::error_code(), *cell);
         }
-        if (!wait_for(lock, wait_duration)) {
+        if (!waited) {
+            waited = true;
+            observer_type::enqueue();
+        }
+        if (!wait_until(lock, deadline)) {
             lock.unlock();
+            _errors.count(error::get_resource_timeout);
+            observer_type::expire(time_traits::now() - start);
             return std::make_pair(make_error_code(error::get_resource_timeout),
                                   list_iterator());
         }
     }
 }
 
-template <class T, class M, class C>
-void pool_impl<T, M, C>::invalidate() {
+template <class T, class M, class C, class O>
+void pool_impl<T, M, C, O>::invalidate() {
     const lock_guard lock(_mutex);
     storage_.invalidate();
 }
 
-template <class T, class M, class C>
-bool pool_impl<T, M, C>::wait_for(unique_lock& lock, time_traits::duration wait_duration) {
-    return _has_capacity.wait_for(lock, wait_duration) == std::cv_status::no_timeout;
+template <class T, class M, class C, class O>
+bool pool_impl<T, M, C, O>::wait_until(unique_lock& lock, time_traits::time_point deadline) {
+    if (_wait.spins > 0 && time_traits::now() < deadline) {
+        const auto releases = _releases.load(std::memory_order_relaxed);
+        const auto released = [&] { return _releases.load(std::memory_order_acquire) != releases; };
+        lock.unlock();
+        resource_pool::detail::spin_until(released, _wait.spins, _wait.max_pause);
+        lock.lock();
+        if (released()) {
+            return true;
+        }
+    }
+    ++_waiters;
+    const auto status = _has_capacity.wait_until(lock, deadline);
+    --_waiters;
+    return status == std::cv_status::no_timeout;
 }
 
-template <class T, class M, class C>
-std::size_t pool_impl<T, M, C>::assert_capacity(std::size_t value) {
+template <class T, class M, class C, class O>
+std::size_t pool_impl<T, M, C, O>::assert_capacity(std::size_t value) {
     if (value == 0) {
         throw error::zero_pool_capacity();
     }
@@ -1,9 +1,11 @@
 #ifndef YAMAIL_RESOURCE_POOL_SYNC_POOL_HPP
 #define YAMAIL_RESOURCE_POOL_SYNC_POOL_HPP
 
+#include <yamail/resource_pool/call_site.hpp>
 #include <yamail/resource_pool/error.hpp>
 #include <yamail/resource_pool/handle.hpp>
 #include <yamail/resource_pool/sync/detail/pool_impl.hpp>
+#include <yamail/resource_pool/sync/detail/fair_pool_impl.hpp>
 
 #include <condition_variable>
 
@@ -27,6 +29,13 @@ public:
             : _impl(std::make_shared<pool_impl>(capacity, idle_timeout, lifespan))
     {}
 
+    pool(std::size_t capacity,
+         time_traits::duration idle_timeout,
+         time_traits::duration lifespan,
+         sync::adaptive_wait wait)
+            : _impl(std::make_shared<pool_impl>(capacity, idle_timeout, lifespan, wait))
+    {}
+
     pool(std::shared_ptr<pool_impl> impl)
             : _impl(std::move(impl))
     {}
@@ -48,13 +57,20 @@ public:
     std::size_t available() const { return _impl->available(); }
     std::size_t used() const { return _impl->used(); }
     sync::stats stats() const { return _impl->stats(); }
+    latency_stats latency() const { return _impl->latency(); }
+    resource_pool::memory_usage memory_usage() const { return _impl->memory_usage(); }
+
+    const pool_impl& impl() const noexcept { return *_impl; }
+    std::shared_ptr<const pool_impl> shared_impl() const noexcept { return _impl; }
 
-    get_result get_auto_waste(time_traits::duration wait_duration = time_traits::duration(0)) {
-        return get_handle(&handle::waste, wait_duration);
+    get_result get_auto_waste(time_traits::duration wait_duration = time_traits::duration(0),
+                              call_site site = call_site::current()) {
+        return get_handle(&handle::waste, wait_duration, site);
     }
 
-    get_result get_auto_recycle(time_traits::duration wait_duration = time_traits::duration(0)) {
-        return get_handle(&handle::recycle, wait_duration);
+    get_result get_auto_recycle(time_traits::duration wait_duration = time_traits::duration(0),
+                                call_site site = call_site::current()) {
+        return get_handle(&handle::recycle, wait_duration, site);
     }
 
     void invalidate() {
@@ -67,12 +83,22 @@ private:
 
     pool_impl_ptr _impl;
 
-    get_result get_handle(strategy use_strategy, time_traits::duration wait_duration) {
+    get_result get_handle(strategy use_strategy, time_traits::duration wait_duration, call_site site) {
         const typename pool_impl::get_result& res = _impl->get(wait_duration);
+        if (res.first) {
+            return std::make_pair(res.first, handle());
+        }
+        resource_pool::detail::set_lease_site(*res.second, site);
         return std::make_pair(res.first, handle(_impl, use_strategy, res.second));
     }
 };
 
+template <class Value, class Mutex = std::mutex>
+using fair_pool = pool<Value, Mutex, detail::fair_pool_impl<Value, Mutex, std::condition_variable>>;
+
+template <class Value, class Observer, class Mutex = std::mutex>
+using observed_pool = pool<Value, Mutex, detail::pool_impl<Value, Mutex, std::condition_variable, Observer>>;
+
 }
 }
 }
@@ -4,17 +4,23 @@
 #include <boost/asio/basic_waitable_timer.hpp>
 
 #include <chrono>
+#include <type_traits>
 
 namespace yamail {
 namespace resource_pool {
 
-struct time_traits {
+template <class Clock, class WaitTraits = boost::asio::wait_traits<Clock>>
+struct basic_time_traits {
+    using clock = Clock;
     using duration = std::chrono::steady_clock::duration;
     using time_point = std::chrono::steady_clock::time_point;
-    using timer = boost::asio::basic_waitable_timer<std::chrono::steady_clock>;
+    using timer = boost::asio::basic_waitable_timer<Clock, WaitTraits>;
+
+    static_assert(std::is_same_v<typename Clock::time_point, time_point>,
+        "Clock must use std::chrono::steady_clock::time_point");
 
     static time_point now() {
-        return std::chrono::steady_clock::now();
+        return Clock::now();
     }
 
     static time_point add(time_point t, duration d) {
@@ -32,6 +38,8 @@ struct time_traits {
     }
 };
 
+using time_traits = basic_time_traits<std::chrono::steady_clock>;
+
 } // namespace resource_pool
 } // namespace yamail
 
@@ -0,0 +1,57 @@
+#ifndef YAMAIL_RESOURCE_POOL_VIRTUAL_CLOCK_HPP
+#define YAMAIL_RESOURCE_POOL_VIRTUAL_CLOCK_HPP
+
+#include <yamail/resource_pool/time_traits.hpp>
+
+#include <atomic>
+
+namespace yamail {
+namespace resource_pool {
+
+// Process wide clock which moves only when advanced explicitly.
+class virtual_clock {
+public:
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        return time_point(duration(ticks().load(std::memory_order_acquire)));
+    }
+
+    static void advance(duration value) noexcept {
+        ticks().fetch_add(value.count(), std::memory_order_acq_rel);
+    }
+
+    static void reset(time_point value = time_point()) noexcept {
+        ticks().store(value.time_since_epoch().count(), std::memory_order_release);
+    }
+
+private:
+    static std::atomic<rep>& ticks() noexcept {
+        static std::atomic<rep> value {0};
+        return value;
+    }
+};
+
+// Asio timers never sleep in real time waiting for virtual deadlines: pending timers are checked on every
+// io_context poll, so advance the clock and then poll or run the io_context.
+struct virtual_wait_traits {
+    static virtual_clock::duration to_wait_duration(const virtual_clock::duration&) {
+        return virtual_clock::duration::zero();
+    }
+
+    static virtual_clock::duration to_wait_duration(const virtual_clock::time_point&) {
+        return virtual_clock::duration::zero();
+    }
+};
+
+using virtual_time_traits = basic_time_traits<virtual_clock, virtual_wait_traits>;
+
+} // namespace resource_pool
+} // namespace yamail
+
+#endif // YAMAIL_RESOURCE_POOL_VIRTUAL_CLOCK_HPP
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+
+"""Run resource_pool benchmarks and compare results against a stored baseline.
+
+Usage:
+    compare.py run --output baseline.json [--repetitions 10] [--filter REGEX] BINARY...
+    compare.py compare baseline.json current.json [--threshold 0.05] [--max-cv 0.1]
+
+The run command stores the median and coefficient of variation of every benchmark.
+The compare command prints a per-benchmark delta table. It exits with status 1 if
+any benchmark got slower by more than the threshold and by more than twice its noise.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+TIME_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def run(args):
+    result = {'context': None, 'benchmarks': []}
+    for binary in args.binaries:
+        with tempfile.NamedTemporaryFile(suffix='.json', delete=False) as output:
+            path = output.name
+        try:
+            command = [
+                binary,
+                '--benchmark_out=' + path,
+                '--benchmark_out_format=json',
+                '--benchmark_repetitions=%d' % args.repetitions,
+                '--benchmark_report_aggregates_only=true',
+            ]
+            if args.filter:
+                command.append('--benchmark_filter=' + args.filter)
+            if args.min_time:
+                command.append('--benchmark_min_time=' + args.min_time)
+            print(' '.join(command), file=sys.stderr)
+            subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+            with open(path) as stream:
+                content = stream.read()
+        finally:
+            os.unlink(path)
+        if not content:
+            continue
+        data = json.loads(content)
+        if result['context'] is None:
+            result['context'] = data['context']
+        name = os.path.basename(binary)
+        for benchmark in data['benchmarks']:
+            benchmark['binary'] = name
+            result['benchmarks'].append(benchmark)
+    with open(args.output, 'w') as stream:
+        json.dump(result, stream, indent=2)
+
+
+def load(path):
+    with open(path) as stream:
+        data = json.load(stream)
+    aggregates = {}
+    for benchmark in data['benchmarks']:
+        if benchmark.get('run_type') != 'aggregate' or 'error_occurred' in benchmark:
+            continue
+        key = (benchmark.get('binary', ''), benchmark['run_name'])
+        value = benchmark['real_time'] * TIME_UNITS[benchmark.get('time_unit', 'ns')]
+        entry = aggregates.setdefault(key, {})
+        entry[benchmark['aggregate_name']] = value
+        if benchmark['aggregate_name'] == 'cv':
+            entry['cv'] = benchmark['real_time']
+    result = {}
+    for key, entry in aggregates.items():
+        if 'median' not in entry:
+            continue
+        cv = entry.get('cv')
+        if cv is None and entry.get('mean'):
+            cv = entry.get('stddev', 0.0) / entry['mean']
+        result[key] = (entry['median'], cv or 0.0)
+    return result
+
+
+def format_time(value):
+    for unit in ('s', 'ms', 'us'):
+        if value >= TIME_UNITS[unit]:
+            return '%.3g %s' % (value / TIME_UNITS[unit], unit)
+    return '%.3g ns' % value
+
+
+def compare(args):
+    baseline = load(args.baseline)
+    current = load(args.current)
+    rows = []
+    regressions = 0
+    for key in sorted(set(baseline) | set(current)):
+        name = '%s: %s' % key if key[0] else key[1]
+        if key not in baseline:
+            rows.append((name, '-', format_time(current[key][0]), '-', '-', 'new'))
+            continue
+        if key not in current:
+            rows.append((name, format_time(baseline[key][0]), '-', '-', '-', 'missing'))
+            continue
+        base_median, base_cv = baseline[key]
+        current_median, current_cv = current[key]
+        delta = (current_median - base_median) / base_median if base_median else 0.0
+        noise = max(base_cv, current_cv)
+        if noise > args.max_cv:
+            status = 'noisy'
+        elif delta > args.threshold and delta > 2 * noise:
+            status = 'REGRESSION'
+            regressions += 1
+        elif delta < -args.threshold and -delta > 2 * noise:
+            status = 'improvement'
+        else:
+            status = 'same'
+        rows.append((name, format_time(base_median), format_time(current_median),
+                     '%+.1f%%' % (delta * 100), '%.1f%%' % (noise * 100), status))
+    header = ('benchmark', 'baseline', 'current', 'delta', 'cv', 'status')
+    widths = [max(len(row[i]) for row in rows + [header]) for i in range(len(header))]
+    for row in [header] + rows:
+        print('  '.join(value.ljust(width) for value, width in zip(row, widths)).rstrip())
+    if regressions:
+        print('\n%d benchmark(s) regressed by more than %.1f%%' % (regressions, args.threshold * 100))
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    run_parser = commands.add_parser('run', help='run benchmarks and store aggregated results')
+    run_parser.add_argument('--output', required=True)
+    run_parser.add_argument('--repetitions', type=int, default=10)
+    run_parser.add_argument('--filter', default='')
+    run_parser.add_argument('--min-time', default='')
+    run_parser.add_argument('binaries', nargs='+')
+
+    compare_parser = commands.add_parser('compare', help='compare two stored results')
+    compare_parser.add_argument('baseline')
+    compare_parser.add_argument('current')
+    compare_parser.add_argument('--threshold', type=float, default=0.05,
+                                help='relative median slowdown treated as regression')
+    compare_parser.add_argument('--max-cv', type=float, default=0.1,
+                                help='results with larger coefficient of variation are reported as noisy')
+
+    args = parser.parse_args()
+    if args.command == 'run':
+        run(args)
+        return 0
+    return compare(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,216 @@
+#include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/sync/pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations {0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* result = std::malloc(size == 0 ? 1 : size)) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+constexpr std::size_t warmup = 16;
+constexpr std::size_t iterations = 256;
+
+// Steady state allocations per operation. Lower them when an optimization removes an allocation.
+constexpr double sync_get_budget = 0;
+constexpr double async_get_immediate_budget = 1;
+constexpr double async_get_queued_budget = 5;
+// Expiration timer is created and armed while combined lock is held.
+constexpr double async_get_queued_under_lock_budget = 3;
+
+template <class Function>
+double allocations_per_call(Function&& function) {
+    for (std::size_t i = 0; i < warmup; ++i) {
+        function();
+    }
+    const auto before = allocations.load();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    return static_cast<double>(allocations.load() - before) / iterations;
+}
+
+template <class Pool>
+struct sync_allocations : Test {};
+
+using sync_pools = Types<sync::pool<int>, sync::fair_pool<int>>;
+
+TYPED_TEST_SUITE(sync_allocations, sync_pools);
+
+TYPED_TEST(sync_allocations, get_auto_recycle_should_not_allocate) {
+    TypeParam pool(1);
+    const auto result = allocations_per_call([&] {
+        auto res = pool.get_auto_recycle();
+        if (res.second.empty()) {
+            res.second.reset(42);
+        }
+    });
+    EXPECT_LE(result, sync_get_budget);
+}
+
+TYPED_TEST(sync_allocations, get_auto_waste_should_not_allocate) {
+    TypeParam pool(1);
+    const auto result = allocations_per_call([&] {
+        auto res = pool.get_auto_waste();
+        res.second.reset(42);
+    });
+    EXPECT_LE(result, sync_get_budget);
+}
+
+TYPED_TEST(sync_allocations, get_with_timeout_error_should_not_allocate) {
+    TypeParam pool(1);
+    auto held = pool.get_auto_recycle();
+    const auto result = allocations_per_call([&] {
+        const auto res = pool.get_auto_recycle();
+        EXPECT_EQ(res.first, error::get_resource_timeout);
+    });
+    EXPECT_LE(result, sync_get_budget);
+}
+
+struct async_allocations : Test {
+    using pool_t = async::pool<int>;
+
+    asio::io_context io;
+};
+
+TEST_F(async_allocations, get_auto_recycle_with_available_resource_should_fit_budget) {
+    pool_t pool(1, 1);
+    const auto result = allocations_per_call([&] {
+        pool.get_auto_recycle(io, [] (boost::system::error_code ec, pool_t::handle handle) {
+            if (!ec && handle.empty()) {
+                handle.reset(42);
+            }
+        });
+        io.restart();
+        io.run();
+    });
+    EXPECT_LE(result, async_get_immediate_budget);
+}
+
+TEST_F(async_allocations, queued_get_auto_recycle_should_fit_budget) {
+    pool_t pool(1, 1);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (boost::system::error_code ec, pool_t::handle handle) {
+        ASSERT_FALSE(ec);
+        handle.reset(42);
+        held = std::move(handle);
+    });
+    io.run();
+    const auto result = allocations_per_call([&] {
+        pool.get_auto_recycle(io, [&] (boost::system::error_code ec, pool_t::handle handle) {
+            ASSERT_FALSE(ec);
+            held = std::move(handle);
+        }, std::chrono::seconds(1));
+        held.recycle();
+        io.restart();
+        io.run();
+    });
+    EXPECT_LE(result, async_get_queued_budget);
+}
+
+TEST(async_combined_lock_allocations, get_auto_recycle_with_available_resource_should_fit_budget) {
+    using pool_t = async::combined_lock_pool<int>;
+    asio::io_context io;
+    pool_t pool(1, 1);
+    const auto result = allocations_per_call([&] {
+        pool.get_auto_recycle(io, [] (boost::system::error_code ec, pool_t::handle handle) {
+            if (!ec && handle.empty()) {
+                handle.reset(42);
+            }
+        });
+        io.restart();
+        io.run();
+    });
+    EXPECT_LE(result, async_get_immediate_budget);
+}
+
+// Counts allocations made while the mutex is held by any thread.
+class allocations_under_lock_mutex {
+public:
+    void lock() {
+        _impl.lock();
+        _locked_at = allocations.load();
+    }
+
+    bool try_lock() {
+        if (!_impl.try_lock()) {
+            return false;
+        }
+        _locked_at = allocations.load();
+        return true;
+    }
+
+    void unlock() {
+        _count += allocations.load() - _locked_at;
+        _impl.unlock();
+    }
+
+    std::size_t count() const { return _count; }
+
+private:
+    std::mutex _impl;
+    std::size_t _locked_at = 0;
+    std::size_t _count = 0;
+};
+
+TEST(async_combined_lock_allocations, queued_get_auto_recycle_should_fit_budget_under_pool_lock) {
+    using pool_t = async::combined_lock_pool<int, allocations_under_lock_mutex>;
+    asio::io_context io;
+    pool_t pool(1, 1);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (boost::system::error_code ec, pool_t::handle handle) {
+        ASSERT_FALSE(ec);
+        handle.reset(42);
+        held = std::move(handle);
+    });
+    io.run();
+    const auto get = [&] {
+        pool.get_auto_recycle(io, [&] (boost::system::error_code ec, pool_t::handle handle) {
+            ASSERT_FALSE(ec);
+            held = std::move(handle);
+        }, std::chrono::seconds(1));
+        held.recycle();
+        io.restart();
+        io.run();
+    };
+    for (std::size_t i = 0; i < warmup; ++i) {
+        get();
+    }
+    const auto before = pool.impl().queue().mutex().count();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        get();
+    }
+    const auto result = static_cast<double>(pool.impl().queue().mutex().count() - before) / iterations;
+    EXPECT_LE(result, async_get_queued_under_lock_budget);
+}
+
+} // namespace
@@ -0,0 +1,209 @@
+#include <yamail/resource_pool/instrumented_mutex.hpp>
+#include <yamail/resource_pool/virtual_clock.hpp>
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <boost/asio/executor_work_guard.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using boost::system::error_code;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+using request_t = std::function<void (error_code)>;
+using mutex_t = instrumented_mutex<std::mutex>;
+using pool_locked_queue_t = async::detail::queue<request_t, mutex_t, asio::io_context,
+    virtual_time_traits::timer, null_observer, virtual_time_traits, async::detail::pool_lock>;
+
+struct async_pool_locked_queue : Test {
+    asio::io_context io;
+
+    void SetUp() override {
+        virtual_clock::reset();
+    }
+};
+
+TEST_F(async_pool_locked_queue, push_and_pop_should_not_lock_mutex) {
+    const auto queue = std::make_shared<pool_locked_queue_t>(2);
+    int served = 0;
+    ASSERT_TRUE(queue->push(io, seconds(1), [&] (error_code ec) { EXPECT_FALSE(ec); ++served; }));
+    queue->pop()->request(error_code());
+    EXPECT_FALSE(queue->pop());
+    EXPECT_EQ(served, 1);
+    EXPECT_EQ(queue->mutex().stats().acquisitions, 0u);
+    EXPECT_EQ(queue->lock_stats().acquisitions, 0u);
+}
+
+TEST_F(async_pool_locked_queue, expiration_should_lock_mutex) {
+    const auto queue = std::make_shared<pool_locked_queue_t>(2);
+    error_code result;
+    ASSERT_TRUE(queue->push(io, seconds(1), [&] (error_code ec) { result = ec; }));
+    virtual_clock::advance(seconds(1));
+    io.poll();
+    EXPECT_EQ(result, error::get_resource_timeout);
+    EXPECT_TRUE(queue->empty());
+    EXPECT_EQ(queue->mutex().stats().acquisitions, 1u);
+}
+
+struct async_combined_lock_pool : Test {
+    using pool_t = async::combined_lock_pool<int, mutex_t>;
+
+    asio::io_context io;
+};
+
+TEST_F(async_combined_lock_pool, queued_request_should_get_recycled_resource_and_report_single_mutex) {
+    pool_t pool(1, 1);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle handle) {
+        ASSERT_FALSE(ec);
+        handle.reset(42);
+        held = std::move(handle);
+    });
+    io.run();
+    int value = 0;
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle handle) {
+        ASSERT_FALSE(ec);
+        value = *handle;
+    }, seconds(10));
+    held.recycle();
+    io.restart();
+    io.run();
+    EXPECT_EQ(value, 42);
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.queue_size, 0u);
+    // Queued get takes the lock again after handler is type-erased.
+    EXPECT_EQ(stats.mutex.acquisitions, 5u);
+    EXPECT_EQ(stats.queue_mutex.acquisitions, 0u);
+}
+
+TEST_F(async_combined_lock_pool, queued_request_should_expire_and_overflow) {
+    pool_t pool(1, 1);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (error_code, pool_t::handle handle) { held = std::move(handle); });
+    io.run();
+    error_code first;
+    error_code second;
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle) { first = ec; }, milliseconds(1));
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle) { second = ec; }, seconds(10));
+    io.restart();
+    io.run();
+    EXPECT_EQ(first, error::get_resource_timeout);
+    EXPECT_EQ(second, error::request_queue_overflow);
+    EXPECT_EQ(pool.stats().counters.get_resource_timeouts, 1u);
+}
+
+// Threads with own io contexts run chains of get and deferred recycle with mixed wait durations. Resource must never
+// be leased twice at once and every request must complete exactly once.
+template <class Pool>
+struct async_pool_stress : Test {};
+
+using stress_pools = Types<async::pool<int>, async::combined_lock_pool<int>>;
+TYPED_TEST_SUITE(async_pool_stress, stress_pools);
+
+TYPED_TEST(async_pool_stress, concurrent_get_and_recycle_should_serve_each_request_once) {
+    using pool_t = TypeParam;
+    using handle_t = typename pool_t::handle;
+
+    constexpr std::size_t capacity = 4;
+    constexpr std::size_t threads_count = 4;
+    constexpr std::size_t chains_per_thread = 4;
+    constexpr std::size_t gets_per_chain = 200;
+    constexpr std::size_t total = threads_count * chains_per_thread * gets_per_chain;
+    const std::array<time_traits::duration, 3> wait_durations {{
+        time_traits::duration(0), milliseconds(1), seconds(10)
+    }};
+
+    pool_t pool(capacity, threads_count * chains_per_thread);
+    std::vector<asio::io_context> ios(threads_count);
+    using work_guard = asio::executor_work_guard<asio::io_context::executor_type>;
+    std::vector<work_guard> guards;
+    for (auto& io : ios) {
+        guards.emplace_back(io.get_executor());
+    }
+    std::array<std::atomic<bool>, capacity> busy {};
+    std::atomic<int> next_id {0};
+    std::atomic<std::size_t> served {0};
+    std::atomic<std::size_t> timeouts {0};
+    std::atomic<std::size_t> overflows {0};
+    std::atomic<std::size_t> finished {0};
+    std::atomic<std::size_t> conflicts {0};
+    std::atomic<std::size_t> unexpected {0};
+
+    std::function<void (asio::io_context&, std::size_t)> start;
+    const auto complete = [&] (asio::io_context& io, std::size_t step) {
+        if (finished.fetch_add(1) + 1 == total) {
+            for (auto& guard : guards) {
+                guard.reset();
+            }
+        }
+        if (step + 1 < gets_per_chain) {
+            start(io, step + 1);
+        }
+    };
+    start = [&] (asio::io_context& io, std::size_t step) {
+        pool.get_auto_recycle(io, [&, step] (error_code ec, handle_t handle) {
+            if (ec == error::get_resource_timeout) {
+                ++timeouts;
+            } else if (ec == error::request_queue_overflow) {
+                ++overflows;
+            } else if (ec) {
+                ++unexpected;
+            } else {
+                ++served;
+                if (handle.empty()) {
+                    handle.reset(next_id++);
+                }
+                const auto id = static_cast<std::size_t>(*handle);
+                if (id >= capacity || busy[id].exchange(true)) {
+                    ++conflicts;
+                }
+                asio::post(io, [&, step, id, handle = std::move(handle)] () mutable {
+                    busy[id] = false;
+                    handle.recycle();
+                    complete(io, step);
+                });
+                return;
+            }
+            complete(io, step);
+        }, wait_durations[step % wait_durations.size()]);
+    };
+
+    std::vector<std::thread> threads;
+    for (auto& io : ios) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i < chains_per_thread; ++i) {
+                asio::post(io, [&] { start(io, 0); });
+            }
+            io.run();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(conflicts.load(), 0u);
+    EXPECT_EQ(unexpected.load(), 0u);
+    EXPECT_EQ(finished.load(), total);
+    EXPECT_EQ(served.load() + timeouts.load() + overflows.load(), total);
+    EXPECT_GT(served.load(), 0u);
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.queue_size, 0u);
+    EXPECT_EQ(stats.used, 0u);
+    EXPECT_EQ(stats.counters.get_resource_timeouts, timeouts.load());
+    EXPECT_EQ(stats.counters.request_queue_overflows, overflows.load());
+}
+
+} // namespace
@@ -1,6 +1,7 @@
 #include <yamail/resource_pool/async/pool.hpp>
 
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <gtest/gtest.h>
 
@@ -180,6 +181,63 @@ TEST_F(async_resource_pool_integration, queue_should_store_pending_requests) {
     EXPECT_TRUE(coroutine_finished.test_and_set());
 }
 
+TEST_F(async_resource_pool_integration, served_pending_request_should_record_wait_latency) {
+    resource_pool pool(1, 1);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto handle = pool.get_auto_recycle(io, yield);
+        ASSERT_FALSE(handle.unusable());
+
+        pool.get_auto_recycle(io, [&] (error_code ec, auto) {
+            EXPECT_FALSE(ec);
+            ASSERT_FALSE(on_get_called.test_and_set());
+        }, time_traits::duration::max());
+
+        ASSERT_FALSE(coroutine_finished.test_and_set());
+    });
+
+    io.run();
+
+    EXPECT_TRUE(on_get_called.test_and_set());
+    const auto latency = pool.latency();
+    EXPECT_EQ(latency.acquire.count(), 2u);
+    EXPECT_EQ(latency.wait.count(), 1u);
+    EXPECT_EQ(latency.hold.count(), 2u);
+}
+
+TEST_F(async_resource_pool_integration, stats_should_count_overflow_and_expired_requests) {
+    resource_pool pool(1, 1);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto handle = pool.get_auto_recycle(io, yield);
+        ASSERT_FALSE(handle.unusable());
+
+        error_code ec;
+        auto unusable = pool.get_auto_recycle(io, yield[ec], time_traits::duration(0));
+        EXPECT_EQ(ec, error_code(error::get_resource_timeout));
+
+        pool.get_auto_recycle(io, [&] (error_code ec, auto) {
+            EXPECT_EQ(ec, error::get_resource_timeout);
+            ASSERT_FALSE(on_get_called.test_and_set());
+        }, std::chrono::milliseconds(1));
+        unusable = pool.get_auto_recycle(io, yield[ec], std::chrono::milliseconds(1));
+        EXPECT_EQ(ec, error_code(error::request_queue_overflow));
+
+        asio::steady_timer timer(io, std::chrono::milliseconds(10));
+        timer.async_wait(yield);
+
+        ASSERT_FALSE(coroutine_finished.test_and_set());
+    });
+
+    io.run();
+
+    EXPECT_TRUE(on_get_called.test_and_set());
+    const auto counters = pool.stats().counters;
+    EXPECT_EQ(counters.empty_leases, 1u);
+    EXPECT_EQ(counters.get_resource_timeouts, 2u);
+    EXPECT_EQ(counters.request_queue_overflows, 1u);
+}
+
 TEST_F(async_resource_pool_integration, for_zero_queue_capacity_should_not_be_pending_requests) {
     resource_pool pool(1, 0);
 
@@ -489,4 +547,49 @@ TEST_F(async_resource_pool_integration, get_auto_waste_should_support_move_only_
     EXPECT_TRUE(on_get_called.test_and_set());
 }
 
+TEST_F(async_resource_pool_integration, affinity_handoff_should_prefer_request_from_releasing_io_context) {
+    using affinity_pool = pool<resource, std::mutex, asio::io_context,
+        default_pool_impl<resource, std::mutex, asio::io_context, affinity_handoff<2>>::type>;
+
+    affinity_pool pool(1, 2);
+    asio::io_context other_io;
+    affinity_pool::handle held;
+    bool other_io_served = false;
+
+    pool.get_auto_recycle(io, [&] (error_code ec, affinity_pool::handle handle) {
+        EXPECT_FALSE(ec);
+        held = std::move(handle);
+    });
+
+    io.run();
+    io.restart();
+
+    ASSERT_FALSE(held.unusable());
+
+    const auto on_get2 = [&] (error_code ec, auto handle) {
+        ASSERT_FALSE(on_get2_called.test_and_set());
+        EXPECT_FALSE(ec);
+        EXPECT_FALSE(handle.unusable());
+        other_io_served = true;
+    };
+
+    const auto on_get1 = [&] (error_code ec, auto handle) {
+        ASSERT_FALSE(on_get1_called.test_and_set());
+        EXPECT_FALSE(ec);
+        EXPECT_FALSE(handle.unusable());
+        EXPECT_FALSE(other_io_served);
+    };
+
+    pool.get_auto_recycle(other_io, on_get2, time_traits::duration::max());
+    pool.get_auto_recycle(io, on_get1, time_traits::duration::max());
+
+    asio::post(io, [&] { held.recycle(); });
+
+    io.run();
+    other_io.run();
+
+    EXPECT_TRUE(on_get1_called.test_and_set());
+    EXPECT_TRUE(on_get2_called.test_and_set());
+}
+
 }
@@ -18,6 +18,7 @@ struct mocked_queue {
     MOCK_CONST_METHOD3(push, bool (mocked_io_context&, time_traits::duration, const value_type&));
     MOCK_CONST_METHOD0(pop, boost::optional<queued_value_t> ());
     MOCK_CONST_METHOD0(size, std::size_t ());
+    MOCK_CONST_METHOD0(expired, std::uint64_t ());
 
     mocked_queue(std::size_t) {}
 };
@@ -285,4 +285,97 @@ TEST_F(async_request_queue, push_twice_with_different_io_serivices_and_timeout_b
     EXPECT_TRUE(queue->empty());
 }
 
+TEST_F(async_request_queue, pop_preferred_should_return_first_request_matching_predicate_within_window) {
+    auto& expired1 = expired;
+    auto expired2 = std::make_shared<mocked_callback>();
+    const auto queue = make_queue(2);
+
+    (void) queue->timer(io1);
+    (void) queue->timer(io2);
+
+    EXPECT_CALL(*queue->timer(io1).impl, expires_at(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io1).impl, async_wait(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io1).impl, cancel()).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, expires_at(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, async_wait(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, cancel()).WillRepeatedly(Return());
+    EXPECT_CALL(*expired1, call(_)).Times(0);
+    EXPECT_CALL(*expired2, call(_)).Times(0);
+
+    EXPECT_TRUE(queue->push(io1, time_traits::duration(1), callback(expired1)));
+    EXPECT_TRUE(queue->push(io2, time_traits::duration(1), callback(expired2)));
+
+    const auto result1 = queue->pop_preferred([&] (const mocked_io_context& io) { return &io == &io2; }, 2);
+    ASSERT_TRUE(result1);
+    EXPECT_EQ(&result1->io_context, &io2);
+    EXPECT_EQ(result1->request.impl, expired2);
+
+    const auto result2 = queue->pop();
+    ASSERT_TRUE(result2);
+    EXPECT_EQ(&result2->io_context, &io1);
+    EXPECT_EQ(result2->request.impl, expired1);
+}
+
+TEST_F(async_request_queue, pop_preferred_without_match_within_window_should_return_first_request) {
+    auto& expired1 = expired;
+    auto expired2 = std::make_shared<mocked_callback>();
+    const auto queue = make_queue(2);
+
+    (void) queue->timer(io1);
+    (void) queue->timer(io2);
+
+    EXPECT_CALL(*queue->timer(io1).impl, expires_at(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io1).impl, async_wait(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io1).impl, cancel()).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, expires_at(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, async_wait(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, cancel()).WillRepeatedly(Return());
+    EXPECT_CALL(*expired1, call(_)).Times(0);
+    EXPECT_CALL(*expired2, call(_)).Times(0);
+
+    EXPECT_TRUE(queue->push(io1, time_traits::duration(1), callback(expired1)));
+    EXPECT_TRUE(queue->push(io2, time_traits::duration(1), callback(expired2)));
+
+    const auto result = queue->pop_preferred([&] (const mocked_io_context& io) { return &io == &io2; }, 1);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(&result->io_context, &io1);
+    EXPECT_EQ(result->request.impl, expired1);
+}
+
+TEST_F(async_request_queue, pop_preferred_should_not_bypass_request_more_than_window_times) {
+    auto& expired1 = expired;
+    auto expired2 = std::make_shared<mocked_callback>();
+    auto expired3 = std::make_shared<mocked_callback>();
+    auto expired4 = std::make_shared<mocked_callback>();
+    const auto queue = make_queue(4);
+    const auto prefer_io2 = [&] (const mocked_io_context& io) { return &io == &io2; };
+
+    (void) queue->timer(io1);
+    (void) queue->timer(io2);
+
+    EXPECT_CALL(*queue->timer(io1).impl, expires_at(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io1).impl, async_wait(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io1).impl, cancel()).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, expires_at(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, async_wait(_)).WillRepeatedly(Return());
+    EXPECT_CALL(*queue->timer(io2).impl, cancel()).WillRepeatedly(Return());
+
+    EXPECT_TRUE(queue->push(io1, time_traits::duration(1), callback(expired1)));
+    EXPECT_TRUE(queue->push(io2, time_traits::duration(1), callback(expired2)));
+    EXPECT_TRUE(queue->push(io2, time_traits::duration(1), callback(expired3)));
+    EXPECT_TRUE(queue->push(io2, time_traits::duration(1), callback(expired4)));
+
+    const auto result1 = queue->pop_preferred(prefer_io2, 2);
+    ASSERT_TRUE(result1);
+    EXPECT_EQ(result1->request.impl, expired2);
+
+    const auto result2 = queue->pop_preferred(prefer_io2, 2);
+    ASSERT_TRUE(result2);
+    EXPECT_EQ(result2->request.impl, expired3);
+
+    const auto result3 = queue->pop_preferred(prefer_io2, 2);
+    ASSERT_TRUE(result3);
+    EXPECT_EQ(result3->request.impl, expired1);
+}
+
 }
@@ -0,0 +1,215 @@
+#include <yamail/resource_pool/virtual_clock.hpp>
+#include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/async/detail/ring_queue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using boost::system::error_code;
+using std::chrono::seconds;
+
+using request_t = std::function<void (error_code)>;
+using ring_queue_t = async::detail::ring_queue<request_t, std::mutex, asio::io_context,
+    virtual_time_traits::timer, null_observer, virtual_time_traits>;
+
+struct async_ring_queue : Test {
+    asio::io_context io;
+    std::vector<int> expired;
+
+    void SetUp() override {
+        virtual_clock::reset();
+    }
+
+    request_t request(int id) {
+        return [this, id] (error_code ec) {
+            EXPECT_EQ(ec, error::get_resource_timeout);
+            expired.push_back(id);
+        };
+    }
+
+    void advance(time_traits::duration duration) {
+        virtual_clock::advance(duration);
+        io.restart();
+        io.poll();
+    }
+};
+
+TEST_F(async_ring_queue, create_then_check_capacity_size_and_empty) {
+    const ring_queue_t queue(3);
+    EXPECT_EQ(queue.capacity(), 3u);
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(async_ring_queue, push_into_queue_with_zero_capacity_should_fail) {
+    const auto queue = std::make_shared<ring_queue_t>(0);
+    EXPECT_FALSE(queue->push(io, seconds(1), request(0)));
+    EXPECT_FALSE(queue->pop());
+}
+
+TEST_F(async_ring_queue, push_over_capacity_should_fail) {
+    const auto queue = std::make_shared<ring_queue_t>(2);
+    EXPECT_TRUE(queue->push(io, seconds(1), request(0)));
+    EXPECT_TRUE(queue->push(io, seconds(1), request(1)));
+    EXPECT_FALSE(queue->push(io, seconds(1), request(2)));
+    EXPECT_EQ(queue->size(), 2u);
+}
+
+TEST_F(async_ring_queue, pop_should_return_requests_in_push_order) {
+    const auto queue = std::make_shared<ring_queue_t>(3);
+    std::vector<int> popped;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue->push(io, seconds(3 - i), [&, i] (error_code) { popped.push_back(i); }));
+    }
+    while (auto value = queue->pop()) {
+        value->request(error_code());
+    }
+    EXPECT_EQ(popped, std::vector<int>({0, 1, 2}));
+    EXPECT_TRUE(queue->empty());
+}
+
+TEST_F(async_ring_queue, requests_with_sorted_deadlines_should_expire_in_order) {
+    const auto queue = std::make_shared<ring_queue_t>(3);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue->push(io, seconds(i + 1), request(i)));
+    }
+    advance(seconds(1));
+    EXPECT_EQ(expired, std::vector<int>({0}));
+    advance(seconds(2));
+    EXPECT_EQ(expired, std::vector<int>({0, 1, 2}));
+    EXPECT_TRUE(queue->empty());
+    EXPECT_EQ(queue->expired(), 3u);
+}
+
+TEST_F(async_ring_queue, requests_with_unsorted_deadlines_should_expire_by_deadline) {
+    const auto queue = std::make_shared<ring_queue_t>(4);
+    ASSERT_TRUE(queue->push(io, seconds(3), request(0)));
+    ASSERT_TRUE(queue->push(io, seconds(1), request(1)));
+    ASSERT_TRUE(queue->push(io, seconds(4), request(2)));
+    ASSERT_TRUE(queue->push(io, seconds(2), request(3)));
+    advance(seconds(1));
+    EXPECT_EQ(expired, std::vector<int>({1}));
+    advance(seconds(1));
+    EXPECT_EQ(expired, std::vector<int>({1, 3}));
+    EXPECT_EQ(queue->size(), 2u);
+    advance(seconds(2));
+    EXPECT_EQ(expired, std::vector<int>({1, 3, 0, 2}));
+}
+
+TEST_F(async_ring_queue, popped_earliest_request_should_not_prevent_expiration_of_next) {
+    const auto queue = std::make_shared<ring_queue_t>(2);
+    ASSERT_TRUE(queue->push(io, seconds(1), request(0)));
+    ASSERT_TRUE(queue->push(io, seconds(2), request(1)));
+    ASSERT_TRUE(queue->pop());
+    advance(seconds(1));
+    EXPECT_TRUE(expired.empty());
+    advance(seconds(1));
+    EXPECT_EQ(expired, std::vector<int>({1}));
+}
+
+TEST_F(async_ring_queue, push_into_full_array_with_tombstones_should_reuse_them) {
+    const auto queue = std::make_shared<ring_queue_t>(3);
+    std::vector<int> popped;
+    const auto served = [&] (int id) { return [&, id] (error_code) { popped.push_back(id); }; };
+    ASSERT_TRUE(queue->push(io, seconds(10), served(0)));
+    ASSERT_TRUE(queue->push(io, seconds(1), request(1)));
+    ASSERT_TRUE(queue->push(io, seconds(10), served(2)));
+    advance(seconds(1));
+    ASSERT_EQ(expired, std::vector<int>({1}));
+    ASSERT_TRUE(queue->push(io, seconds(10), served(3)));
+    EXPECT_FALSE(queue->push(io, seconds(10), served(4)));
+    while (auto value = queue->pop()) {
+        value->request(error_code());
+    }
+    EXPECT_EQ(popped, std::vector<int>({0, 2, 3}));
+}
+
+TEST_F(async_ring_queue, push_and_pop_should_wrap_around_array) {
+    const auto queue = std::make_shared<ring_queue_t>(2);
+    std::vector<int> popped;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue->push(io, seconds(10), [&, i] (error_code) { popped.push_back(i); }));
+        if (i % 2 == 1) {
+            queue->pop()->request(error_code());
+            queue->pop()->request(error_code());
+        }
+    }
+    EXPECT_EQ(popped, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_F(async_ring_queue, pop_preferred_should_select_matching_request_within_window) {
+    asio::io_context other;
+    const auto queue = std::make_shared<ring_queue_t>(3);
+    std::vector<int> popped;
+    ASSERT_TRUE(queue->push(other, seconds(10), [&] (error_code) { popped.push_back(0); }));
+    ASSERT_TRUE(queue->push(io, seconds(10), [&] (error_code) { popped.push_back(1); }));
+    ASSERT_TRUE(queue->push(other, seconds(10), [&] (error_code) { popped.push_back(2); }));
+    const auto preferred = [&] (const asio::io_context& value) { return &value == &io; };
+    queue->pop_preferred(preferred, 2)->request(error_code());
+    queue->pop_preferred(preferred, 2)->request(error_code());
+    queue->pop_preferred(preferred, 2)->request(error_code());
+    EXPECT_EQ(popped, std::vector<int>({1, 0, 2}));
+}
+
+TEST_F(async_ring_queue, memory_usage_should_count_preallocated_slots) {
+    const auto queue = std::make_shared<ring_queue_t>(4);
+    ASSERT_TRUE(queue->push(io, seconds(10), request(0)));
+    const auto usage = queue->memory_usage();
+    EXPECT_GT(usage.queue_nodes, 0u);
+    EXPECT_EQ(usage.queued, 1u);
+    EXPECT_EQ(usage.free_queue_nodes, 3u);
+}
+
+struct async_ring_pool : Test {
+    using pool_t = async::ring_pool<int>;
+
+    asio::io_context io;
+};
+
+TEST_F(async_ring_pool, queued_request_should_get_recycled_resource) {
+    pool_t pool(1, 2);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle handle) {
+        ASSERT_FALSE(ec);
+        handle.reset(42);
+        held = std::move(handle);
+    });
+    io.run();
+    int value = 0;
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle handle) {
+        ASSERT_FALSE(ec);
+        value = *handle;
+    }, seconds(10));
+    held.recycle();
+    io.restart();
+    io.run();
+    EXPECT_EQ(value, 42);
+    EXPECT_EQ(pool.stats().queue_size, 0u);
+}
+
+TEST_F(async_ring_pool, queued_request_should_expire_and_overflow) {
+    pool_t pool(1, 1);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (error_code, pool_t::handle handle) { held = std::move(handle); });
+    io.run();
+    error_code first;
+    error_code second;
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle) { first = ec; }, std::chrono::milliseconds(1));
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle) { second = ec; }, seconds(10));
+    io.restart();
+    io.run();
+    EXPECT_EQ(first, error::get_resource_timeout);
+    EXPECT_EQ(second, error::request_queue_overflow);
+    EXPECT_EQ(pool.stats().counters.get_resource_timeouts, 1u);
+}
+
+} // namespace
@@ -0,0 +1,61 @@
+#include <yamail/resource_pool/histogram.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+using std::chrono::nanoseconds;
+using std::chrono::microseconds;
+
+TEST(histogram, bucket_upper_bound_should_be_greater_than_value) {
+    for (std::uint64_t value : {0ull, 1ull, 3ull, 4ull, 5ull, 7ull, 8ull, 1000ull, 123456789ull, 1ull << 40}) {
+        const auto bucket = histogram_snapshot::bucket(value);
+        EXPECT_GT(histogram_snapshot::upper_bound(bucket), nanoseconds(value)) << value;
+        if (bucket > 0) {
+            EXPECT_LE(histogram_snapshot::upper_bound(bucket - 1), nanoseconds(value)) << value;
+        }
+    }
+}
+
+TEST(histogram, bucket_for_too_large_value_should_be_last) {
+    EXPECT_EQ(histogram_snapshot::bucket(std::uint64_t(1) << 50), histogram_snapshot::buckets_count - 1);
+}
+
+TEST(histogram, empty_snapshot_should_have_zero_count_and_percentiles) {
+    const histogram h;
+    const auto snapshot = h.snapshot();
+    EXPECT_EQ(snapshot.count(), 0u);
+    EXPECT_EQ(snapshot.percentile(0.5), time_traits::duration::zero());
+    EXPECT_EQ(snapshot.max(), time_traits::duration::zero());
+}
+
+TEST(histogram, record_then_snapshot_should_return_count_sum_and_max) {
+    histogram h;
+    h.record(microseconds(1));
+    h.record(microseconds(3));
+    h.record(nanoseconds(-1));
+    const auto snapshot = h.snapshot();
+    EXPECT_EQ(snapshot.count(), 3u);
+    EXPECT_EQ(snapshot.sum(), microseconds(4));
+    EXPECT_EQ(snapshot.max(), microseconds(3));
+}
+
+TEST(histogram, percentile_should_be_within_bucket_relative_error) {
+    histogram h;
+    for (int i = 1; i <= 1000; ++i) {
+        h.record(microseconds(i));
+    }
+    const auto snapshot = h.snapshot();
+    const auto p50 = snapshot.percentile(0.5);
+    EXPECT_GE(p50, microseconds(500));
+    EXPECT_LE(p50, microseconds(500) * 5 / 4);
+    const auto p99 = snapshot.percentile(0.99);
+    EXPECT_GE(p99, microseconds(990));
+    EXPECT_LE(p99, microseconds(1000));
+    EXPECT_EQ(snapshot.percentile(1), microseconds(1000));
+}
+
+}
@@ -0,0 +1,102 @@
+#include <yamail/resource_pool/instrumented_mutex.hpp>
+#include <yamail/resource_pool/sync/pool.hpp>
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+struct resource {};
+
+TEST(instrumented_mutex, lock_and_unlock_should_count_acquisition) {
+    instrumented_mutex<> mutex;
+    mutex.lock();
+    mutex.unlock();
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    const auto stats = mutex.stats();
+    EXPECT_EQ(stats.acquisitions, 2u);
+    EXPECT_EQ(stats.contended, 0u);
+    EXPECT_EQ(stats.wait_time, time_traits::duration::zero());
+}
+
+TEST(instrumented_mutex, try_lock_locked_should_not_count_acquisition) {
+    instrumented_mutex<> mutex;
+    mutex.lock();
+    std::thread([&] { EXPECT_FALSE(mutex.try_lock()); }).join();
+    mutex.unlock();
+
+    EXPECT_EQ(mutex.stats().acquisitions, 1u);
+}
+
+TEST(instrumented_mutex, lock_locked_should_count_contended_acquisition_and_wait_time) {
+    instrumented_mutex<> mutex;
+    std::atomic_bool started {false};
+    mutex.lock();
+    std::thread thread([&] {
+        started = true;
+        mutex.lock();
+        mutex.unlock();
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    mutex.unlock();
+    thread.join();
+
+    const auto stats = mutex.stats();
+    EXPECT_EQ(stats.acquisitions, 2u);
+    EXPECT_EQ(stats.contended, 1u);
+    EXPECT_GT(stats.wait_time, time_traits::duration::zero());
+    EXPECT_GE(stats.hold_time, std::chrono::milliseconds(10));
+}
+
+TEST(instrumented_mutex, sync_pool_stats_should_contain_mutex_stats) {
+    using mutex = instrumented_mutex<>;
+    sync::pool<resource, mutex, sync::detail::pool_impl<resource, mutex, std::condition_variable_any>> pool(1);
+    {
+        const auto res = pool.get_auto_waste();
+        ASSERT_FALSE(res.first);
+    }
+    EXPECT_EQ(pool.stats().mutex.acquisitions, 2u);
+}
+
+TEST(instrumented_mutex, pool_stats_should_not_lock_pool_mutex) {
+    using mutex = instrumented_mutex<>;
+    sync::pool<resource, mutex, sync::detail::pool_impl<resource, mutex, std::condition_variable_any>> sync_pool(1);
+    sync_pool.stats();
+    sync_pool.size();
+    sync_pool.available();
+    sync_pool.used();
+    EXPECT_EQ(sync_pool.stats().mutex.acquisitions, 0u);
+
+    async::pool<resource, mutex> async_pool(1, 1);
+    async_pool.stats();
+    async_pool.size();
+    async_pool.available();
+    async_pool.used();
+    const auto stats = async_pool.stats();
+    EXPECT_EQ(stats.mutex.acquisitions, 0u);
+    EXPECT_EQ(stats.queue_mutex.acquisitions, 0u);
+}
+
+TEST(instrumented_mutex, async_pool_stats_should_contain_pool_and_queue_mutex_stats) {
+    boost::asio::io_context io;
+    async::pool<resource, instrumented_mutex<>> pool(1, 1);
+    pool.get_auto_waste(io, [] (boost::system::error_code, auto) {});
+    pool.get_auto_waste(io, [] (boost::system::error_code, auto) {}, time_traits::duration::max());
+    io.run();
+
+    const auto stats = pool.stats();
+    EXPECT_GT(stats.mutex.acquisitions, 0u);
+    EXPECT_GT(stats.queue_mutex.acquisitions, 0u);
+}
+
+}
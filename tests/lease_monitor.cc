@@ -0,0 +1,127 @@
+#include <yamail/resource_pool/lease_monitor.hpp>
+#include <yamail/resource_pool/virtual_clock.hpp>
+#include <yamail/resource_pool/sync/pool.hpp>
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+struct resource {};
+
+using std::chrono::seconds;
+using std::chrono::milliseconds;
+
+TEST(lease_monitor, check_should_report_lease_held_beyond_max_duration_once) {
+    asio::io_context io;
+    sync::pool<resource> pool(2);
+    std::vector<lease_info> reported;
+    const auto monitor = make_lease_monitor(io, pool, seconds(1), seconds(1),
+        [&] (const lease_info& info) { reported.push_back(info); });
+
+    const auto line = __LINE__ + 1;
+    const auto res = pool.get_auto_waste();
+    ASSERT_FALSE(res.first);
+
+    EXPECT_EQ(monitor->check(), 0u);
+    EXPECT_EQ(monitor->check(time_traits::now() + seconds(2)), 1u);
+    EXPECT_EQ(monitor->check(time_traits::now() + seconds(3)), 0u);
+
+    ASSERT_EQ(reported.size(), 1u);
+    EXPECT_GE(reported.front().held, seconds(2));
+#if YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE
+    ASSERT_NE(reported.front().site.file, nullptr);
+    EXPECT_NE(std::strstr(reported.front().site.file, "lease_monitor.cc"), nullptr);
+    EXPECT_EQ(reported.front().site.line, line);
+#else
+    static_cast<void>(line);
+#endif
+
+    const auto stats = monitor->stats();
+    EXPECT_EQ(stats.checks, 3u);
+    EXPECT_EQ(stats.overdue_leases, 1u);
+    EXPECT_EQ(stats.overdue, 1u);
+}
+
+TEST(lease_monitor, check_after_return_should_not_report_lease) {
+    asio::io_context io;
+    sync::pool<resource> pool(1);
+    const auto monitor = make_lease_monitor(io, pool, seconds(1), seconds(1), [] (const lease_info&) {});
+    {
+        const auto res = pool.get_auto_recycle();
+        ASSERT_FALSE(res.first);
+    }
+    EXPECT_EQ(monitor->check(time_traits::now() + seconds(2)), 0u);
+    EXPECT_EQ(monitor->stats().overdue, 0u);
+}
+
+TEST(lease_monitor, started_monitor_should_check_async_pool_periodically) {
+    asio::io_context io;
+    async::pool<resource> pool(1, 0);
+    std::size_t reported = 0;
+    const auto monitor = make_lease_monitor(io, pool, milliseconds(1), milliseconds(1),
+        [&] (const lease_info&) { ++reported; });
+
+    async::pool<resource>::handle handle;
+    pool.get_auto_waste(io, [&] (boost::system::error_code ec, auto h) {
+        EXPECT_FALSE(ec);
+        handle = std::move(h);
+    });
+    monitor->start();
+    io.run_for(milliseconds(50));
+    monitor->stop();
+
+    EXPECT_EQ(reported, 1u);
+    EXPECT_GT(monitor->stats().checks, 1u);
+}
+
+TEST(lease_monitor, started_monitor_should_stop_checks_after_pool_destruction) {
+    asio::io_context io;
+    std::size_t reported = 0;
+    std::shared_ptr<lease_monitor<async::pool<resource>::pool_impl>> monitor;
+    {
+        async::pool<resource> pool(1, 0);
+        monitor = make_lease_monitor(io, pool, milliseconds(1), milliseconds(1),
+            [&] (const lease_info&) { ++reported; });
+        monitor->start();
+    }
+    io.run_for(milliseconds(20));
+
+    EXPECT_EQ(monitor->check(), 0u);
+    EXPECT_EQ(reported, 0u);
+    EXPECT_EQ(monitor->stats().checks, 0u);
+}
+
+TEST(lease_monitor, monitor_of_timed_pool_should_use_pool_time_traits) {
+    using pool_t = async::timed_pool<resource, virtual_time_traits>;
+    virtual_clock::reset();
+    asio::io_context io;
+    pool_t pool(1, 0);
+    std::vector<lease_info> reported;
+    const auto monitor = make_lease_monitor(io, pool, seconds(1), seconds(1),
+        [&] (const lease_info& info) { reported.push_back(info); });
+
+    pool_t::handle handle;
+    pool.get_auto_waste(io, [&] (boost::system::error_code ec, auto h) {
+        EXPECT_FALSE(ec);
+        handle = std::move(h);
+    });
+    io.poll();
+    monitor->start();
+    virtual_clock::advance(seconds(2));
+    io.restart();
+    io.poll();
+    monitor->stop();
+
+    ASSERT_EQ(reported.size(), 1u);
+    EXPECT_EQ(reported.front().held, seconds(2));
+}
+
+}
@@ -0,0 +1,141 @@
+#include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/sync/pool.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using boost::system::error_code;
+using std::chrono::seconds;
+
+template <class Pool>
+struct sync_pool_memory_usage : Test {};
+
+using sync_pools = Types<sync::pool<int>, sync::fair_pool<int>>;
+TYPED_TEST_SUITE(sync_pool_memory_usage, sync_pools);
+
+TYPED_TEST(sync_pool_memory_usage, cells_should_grow_with_capacity) {
+    const TypeParam small(1);
+    const TypeParam large(100);
+    EXPECT_GT(small.memory_usage().cells, 0u);
+    EXPECT_EQ(large.memory_usage().cells, 100 * small.memory_usage().cells);
+    EXPECT_GT(small.memory_usage().pool, 0u);
+    EXPECT_EQ(small.memory_usage().queue_nodes, 0u);
+}
+
+TYPED_TEST(sync_pool_memory_usage, total_should_not_depend_on_leases) {
+    TypeParam pool(2);
+    const auto before = pool.memory_usage().total();
+    auto [ec, handle] = pool.get_auto_recycle();
+    ASSERT_FALSE(ec);
+    handle.reset(42);
+    EXPECT_EQ(pool.memory_usage().total(), before);
+}
+
+struct async_pool_memory_usage : Test {
+    using pool_t = async::pool<int>;
+
+    asio::io_context io;
+};
+
+TEST_F(async_pool_memory_usage, queue_nodes_should_not_be_allocated_before_first_waiter) {
+    const pool_t pool(10, 100);
+    const auto usage = pool.memory_usage();
+    EXPECT_GT(usage.cells, 0u);
+    EXPECT_EQ(usage.queued, 0u);
+    EXPECT_EQ(usage.free_queue_nodes, 0u);
+    EXPECT_EQ(usage.queue_nodes, 0u);
+    EXPECT_EQ(usage.handlers, 0u);
+    EXPECT_EQ(usage.total(), usage.pool + usage.cells + usage.queue_nodes + usage.timers);
+}
+
+TEST_F(async_pool_memory_usage, queue_nodes_should_grow_up_to_queue_capacity) {
+    pool_t pool(1, 5);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (error_code, pool_t::handle handle) { held = std::move(handle); });
+    io.poll();
+    for (int i = 0; i < 5; ++i) {
+        pool.get_auto_recycle(io, [] (error_code, pool_t::handle) {}, seconds(10));
+    }
+    const auto usage = pool.memory_usage();
+    EXPECT_EQ(usage.queued, 5u);
+    EXPECT_EQ(usage.free_queue_nodes, 0u);
+    error_code overflow;
+    pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle) { overflow = ec; }, seconds(10));
+    io.restart();
+    io.poll();
+    EXPECT_EQ(overflow, error::request_queue_overflow);
+    EXPECT_EQ(pool.memory_usage().queue_nodes, usage.queue_nodes);
+}
+
+TEST_F(async_pool_memory_usage, should_account_queued_waiters) {
+    pool_t pool(1, 100);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (error_code, pool_t::handle handle) { held = std::move(handle); });
+    io.poll();
+    for (int i = 0; i < 10; ++i) {
+        pool.get_auto_recycle(io, [] (error_code, pool_t::handle) {}, seconds(10));
+    }
+    const auto usage = pool.memory_usage();
+    EXPECT_EQ(usage.queued, 10u);
+    EXPECT_LT(usage.free_queue_nodes, 90u);
+    EXPECT_GT(usage.queue_nodes, 0u);
+    EXPECT_GT(usage.handlers, 0u);
+    EXPECT_GT(usage.timers, 0u);
+    pool.get_auto_recycle(io, [] (error_code, pool_t::handle) {}, seconds(10));
+    const auto more = pool.memory_usage();
+    EXPECT_EQ(more.handlers - usage.handlers, usage.handlers / 10);
+}
+
+TEST_F(async_pool_memory_usage, served_queue_nodes_should_be_returned_to_free_list) {
+    pool_t pool(1, 100);
+    pool_t::handle held;
+    pool.get_auto_recycle(io, [&] (error_code, pool_t::handle handle) { held = std::move(handle); });
+    io.poll();
+    for (int i = 0; i < 3; ++i) {
+        pool.get_auto_recycle(io, [] (error_code, pool_t::handle) {}, seconds(10));
+    }
+    const auto queued = pool.memory_usage();
+    held.recycle();
+    io.restart();
+    io.poll();
+    const auto usage = pool.memory_usage();
+    EXPECT_EQ(usage.queued, 0u);
+    EXPECT_EQ(usage.handlers, 0u);
+    EXPECT_EQ(usage.free_queue_nodes + usage.queued, queued.free_queue_nodes + queued.queued);
+    EXPECT_EQ(usage.queue_nodes, queued.queue_nodes);
+}
+
+TEST_F(async_pool_memory_usage, drained_queue_should_keep_nodes_for_twice_last_peak) {
+    pool_t pool(1, 100);
+    const auto queue_and_drain = [&] (std::size_t waiters) {
+        pool_t::handle held;
+        pool.get_auto_recycle(io, [&] (error_code, pool_t::handle handle) { held = std::move(handle); });
+        io.restart();
+        io.poll();
+        for (std::size_t i = 0; i < waiters; ++i) {
+            pool.get_auto_recycle(io, [] (error_code, pool_t::handle) {}, seconds(10));
+        }
+        const auto queued = pool.memory_usage();
+        held.recycle();
+        io.restart();
+        io.poll();
+        return queued;
+    };
+    const auto burst = queue_and_drain(64);
+    EXPECT_EQ(pool.memory_usage().queue_nodes, burst.queue_nodes);
+    queue_and_drain(1);
+    const auto shrunk = pool.memory_usage();
+    EXPECT_EQ(shrunk.queued, 0u);
+    EXPECT_EQ(shrunk.free_queue_nodes, 2u);
+    EXPECT_LT(shrunk.queue_nodes, burst.queue_nodes);
+    queue_and_drain(1);
+    EXPECT_EQ(pool.memory_usage().queue_nodes, shrunk.queue_nodes);
+}
+
+} // namespace
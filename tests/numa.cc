@@ -0,0 +1,192 @@
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+struct fake_topology {
+    static thread_local std::size_t current;
+
+    std::size_t nodes() const noexcept { return 2; }
+
+    std::size_t current_node() const noexcept { return current; }
+};
+
+thread_local std::size_t fake_topology::current = 0;
+
+using numa_storage = detail::numa_storage<int, fake_topology>;
+
+struct numa_topology_test : Test {};
+
+TEST(numa_topology_test, parse_list_should_expand_ranges) {
+    const std::vector<std::size_t> expected {0, 1, 2, 3, 8, 10, 11};
+    EXPECT_EQ(numa_topology::parse_list("0-3,8,10-11\n"), expected);
+}
+
+TEST(numa_topology_test, parse_list_should_skip_invalid_items) {
+    const std::vector<std::size_t> expected {1, 3};
+    EXPECT_EQ(numa_topology::parse_list("1,x,3"), expected);
+}
+
+TEST(numa_topology_test, create_with_cpu_nodes_should_map_cpu_to_node) {
+    const numa_topology topology({0, 0, 1, 1});
+    EXPECT_EQ(topology.nodes(), 2u);
+    EXPECT_EQ(topology.node(1), 0u);
+    EXPECT_EQ(topology.node(2), 1u);
+    EXPECT_EQ(topology.node(42), 0u);
+}
+
+TEST(numa_topology_test, create_with_sparse_node_ids_should_index_only_nodes_with_cpus) {
+    const numa_topology topology({0, 0, 2, 2});
+    EXPECT_EQ(topology.nodes(), 2u);
+    EXPECT_EQ(topology.node_ids(), std::vector<std::size_t>({0, 2}));
+    EXPECT_EQ(topology.node(3), 2u);
+    EXPECT_EQ(topology.node_index(1), 0u);
+    EXPECT_EQ(topology.node_index(3), 1u);
+    EXPECT_EQ(topology.node_index(42), 0u);
+}
+
+TEST(numa_topology_test, read_cpu_nodes_should_assign_offline_cpus_to_first_node) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::path(TempDir()) / "resource_pool_numa_topology_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "node1");
+    fs::create_directories(root / "node3");
+    std::ofstream(root / "possible") << "1,3\n";
+    std::ofstream(root / "node1" / "cpulist") << "0-1\n";
+    std::ofstream(root / "node3" / "cpulist") << "3\n";
+    const std::vector<std::size_t> expected {1, 1, 1, 3};
+    EXPECT_EQ(numa_topology::read_cpu_nodes(root.string()), expected);
+    fs::remove_all(root);
+}
+
+TEST(numa_topology_test, create_without_cpu_nodes_should_have_one_node) {
+    const numa_topology topology(std::vector<std::size_t> {});
+    EXPECT_EQ(topology.nodes(), 1u);
+    EXPECT_EQ(topology.current_node(), 0u);
+}
+
+TEST(numa_topology_test, read_cpu_nodes_from_missing_path_should_return_empty) {
+    EXPECT_TRUE(numa_topology::read_cpu_nodes("/nonexistent").empty());
+}
+
+TEST(numa_topology_test, create_default_should_have_at_least_one_node) {
+    const numa_topology topology;
+    EXPECT_GE(topology.nodes(), 1u);
+    EXPECT_LT(topology.current_node(), topology.nodes());
+}
+
+struct numa_storage_test : Test {
+    numa_storage_test() { fake_topology::current = 0; }
+};
+
+TEST_F(numa_storage_test, create_should_split_capacity_between_nodes) {
+    const numa_storage storage(3, time_traits::duration::max(), time_traits::duration::max());
+    const auto stats = storage.node_stats();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[0].wasted, 2u);
+    EXPECT_EQ(stats[1].wasted, 1u);
+    EXPECT_EQ(storage.stats().wasted, 3u);
+}
+
+TEST_F(numa_storage_test, lease_should_prefer_local_node) {
+    numa_storage storage(4, time_traits::duration::max(), time_traits::duration::max());
+    fake_topology::current = 1;
+    const auto cell = storage.lease();
+    ASSERT_TRUE(cell);
+    EXPECT_EQ(storage.partition(*cell), 1u);
+    const auto stats = storage.node_stats();
+    EXPECT_EQ(stats[0].used, 0u);
+    EXPECT_EQ(stats[1].used, 1u);
+}
+
+TEST_F(numa_storage_test, lease_should_use_remote_node_when_local_is_exhausted) {
+    numa_storage storage(2, time_traits::duration::max(), time_traits::duration::max());
+    fake_topology::current = 1;
+    const auto local = storage.lease();
+    ASSERT_TRUE(local);
+    const auto remote = storage.lease();
+    ASSERT_TRUE(remote);
+    EXPECT_EQ(storage.partition(*local), 1u);
+    EXPECT_EQ(storage.partition(*remote), 0u);
+    EXPECT_FALSE(storage.lease());
+}
+
+TEST_F(numa_storage_test, recycle_should_return_cell_to_its_node) {
+    numa_storage storage(2, time_traits::duration::max(), time_traits::duration::max());
+    fake_topology::current = 1;
+    const auto cell = storage.lease();
+    ASSERT_TRUE(cell);
+    (*cell)->value = 42;
+    (*cell)->reset_time = time_traits::now();
+    fake_topology::current = 0;
+    storage.recycle(*cell);
+    const auto stats = storage.node_stats();
+    EXPECT_EQ(stats[0].available, 0u);
+    EXPECT_EQ(stats[1].available, 1u);
+}
+
+TEST_F(numa_storage_test, lease_should_prefer_local_available_over_remote) {
+    numa_storage storage([] { return 13; }, 2, time_traits::duration::max(), time_traits::duration::max());
+    fake_topology::current = 1;
+    const auto cell = storage.lease();
+    ASSERT_TRUE(cell);
+    EXPECT_EQ(storage.partition(*cell), 1u);
+    ASSERT_TRUE((*cell)->value);
+    EXPECT_EQ(*(*cell)->value, 13);
+}
+
+TEST_F(numa_storage_test, memory_usage_should_equal_partitions_without_per_cell_index) {
+    const numa_storage storage(4, time_traits::duration::max(), time_traits::duration::max());
+    const detail::storage<int> partition(2, time_traits::duration::max(), time_traits::duration::max());
+    EXPECT_EQ(storage.memory_usage(), 2 * sizeof(detail::storage<int>) + 2 * partition.memory_usage());
+}
+
+TEST_F(numa_storage_test, cell_should_not_grow_for_partition_index) {
+    struct cell_without_partition {
+        boost::optional<int> value;
+        time_traits::time_point drop_time;
+        time_traits::time_point reset_time;
+        time_traits::time_point lease_time;
+        bool waste_on_recycle;
+#if YAMAIL_RESOURCE_POOL_TRACK_LEASE_SITE
+        std::atomic<const char*> lease_file;
+        std::atomic<unsigned> lease_line;
+#endif
+    };
+    EXPECT_EQ(sizeof(detail::idle<int>), sizeof(cell_without_partition));
+}
+
+TEST_F(numa_storage_test, invalidate_should_waste_available_cells_on_all_nodes) {
+    numa_storage storage([] { return 13; }, 2, time_traits::duration::max(), time_traits::duration::max());
+    storage.invalidate();
+    EXPECT_EQ(storage.stats().available, 0u);
+    EXPECT_EQ(storage.stats().wasted, 2u);
+}
+
+TEST_F(numa_storage_test, numa_pool_should_report_stats_per_node) {
+    boost::asio::io_context io;
+    async::numa_pool<int, std::mutex, boost::asio::io_context, fake_topology> pool(2, 0);
+    fake_topology::current = 1;
+    bool called = false;
+    pool.get_auto_recycle(io, [&] (boost::system::error_code ec, auto handle) {
+        EXPECT_FALSE(ec);
+        handle.reset(42);
+        called = true;
+    });
+    io.run();
+    EXPECT_TRUE(called);
+    const auto stats = pool.node_stats();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[0].available, 0u);
+    EXPECT_EQ(stats[1].available, 1u);
+    EXPECT_EQ(pool.stats().available, 1u);
+}
+
+}
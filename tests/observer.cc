@@ -0,0 +1,97 @@
+#include <yamail/resource_pool/sync/pool.hpp>
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using boost::system::error_code;
+
+struct resource {};
+
+struct counting_observer {
+    static inline std::size_t leases = 0;
+    static inline std::size_t recycles = 0;
+    static inline std::size_t wastes = 0;
+    static inline std::size_t enqueues = 0;
+    static inline std::size_t dequeues = 0;
+    static inline std::size_t expires = 0;
+    static inline std::size_t overflows = 0;
+
+    static void lease(time_traits::duration) { ++leases; }
+    static void recycle(time_traits::duration) { ++recycles; }
+    static void waste(time_traits::duration) { ++wastes; }
+    static void enqueue() { ++enqueues; }
+    static void dequeue(time_traits::duration) { ++dequeues; }
+    static void expire(time_traits::duration) { ++expires; }
+    static void overflow() { ++overflows; }
+
+    static void reset() {
+        leases = recycles = wastes = enqueues = dequeues = expires = overflows = 0;
+    }
+};
+
+struct observer : Test {
+    void SetUp() override {
+        counting_observer::reset();
+    }
+};
+
+TEST_F(observer, sync_pool_should_notify_about_lease_recycle_waste_and_expire) {
+    sync::observed_pool<resource, counting_observer> pool(1);
+    {
+        auto res = pool.get_auto_recycle();
+        ASSERT_FALSE(res.first);
+        res.second.reset(resource {});
+        EXPECT_EQ(pool.get_auto_recycle(std::chrono::milliseconds(1)).first, error::get_resource_timeout);
+    }
+    {
+        auto res = pool.get_auto_waste();
+        ASSERT_FALSE(res.first);
+    }
+
+    EXPECT_EQ(counting_observer::leases, 2u);
+    EXPECT_EQ(counting_observer::recycles, 1u);
+    EXPECT_EQ(counting_observer::wastes, 1u);
+    EXPECT_EQ(counting_observer::enqueues, 1u);
+    EXPECT_EQ(counting_observer::dequeues, 0u);
+    EXPECT_EQ(counting_observer::expires, 1u);
+    EXPECT_EQ(counting_observer::overflows, 0u);
+}
+
+TEST_F(observer, async_pool_should_notify_about_queue_events) {
+    asio::io_context io;
+    async::observed_pool<resource, counting_observer> pool(1, 1);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto handle = pool.get_auto_waste(io, yield);
+        ASSERT_FALSE(handle.unusable());
+
+        error_code ec;
+        auto expired = pool.get_auto_waste(io, yield[ec], std::chrono::milliseconds(1));
+        EXPECT_EQ(ec, error_code(error::get_resource_timeout));
+
+        pool.get_auto_waste(io, [] (error_code ec, auto) { EXPECT_FALSE(ec); }, time_traits::duration::max());
+        auto overflowed = pool.get_auto_waste(io, yield[ec], time_traits::duration::max());
+        EXPECT_EQ(ec, error_code(error::request_queue_overflow));
+    });
+
+    io.run();
+
+    EXPECT_EQ(counting_observer::leases, 2u);
+    EXPECT_EQ(counting_observer::wastes, 2u);
+    EXPECT_EQ(counting_observer::enqueues, 2u);
+    EXPECT_EQ(counting_observer::dequeues, 1u);
+    EXPECT_EQ(counting_observer::expires, 1u);
+    EXPECT_EQ(counting_observer::overflows, 1u);
+}
+
+}
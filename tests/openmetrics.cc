@@ -0,0 +1,67 @@
+#include <yamail/resource_pool/openmetrics.hpp>
+#include <yamail/resource_pool/sync/pool.hpp>
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+struct resource {};
+
+TEST(openmetrics, write_should_render_gauges_counters_and_histograms_for_each_pool) {
+    sync::pool<resource> sync_pool(2);
+    {
+        const auto res = sync_pool.get_auto_waste();
+        ASSERT_FALSE(res.first);
+    }
+    async::pool<resource> async_pool(3, 1);
+
+    std::array<char, 64 * 1024> buffer;
+    const auto result = openmetrics::write(buffer.data(), buffer.size(),
+        openmetrics::named("sync", sync_pool), openmetrics::named("as\"ync", async_pool));
+    const std::string text(result);
+
+    EXPECT_NE(text.find("# TYPE resource_pool_capacity gauge\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_capacity{pool=\"sync\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_capacity{pool=\"as\\\"ync\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_queue_size{pool=\"as\\\"ync\"} 0\n"), std::string::npos);
+    EXPECT_EQ(text.find("resource_pool_queue_size{pool=\"sync\"}"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_leases_total{pool=\"sync\",kind=\"empty\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE resource_pool_hold_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_hold_seconds_bucket{pool=\"sync\",le=\"+Inf\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_hold_seconds_count{pool=\"sync\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_mutex_acquisitions_total{pool=\"as\\\"ync\",mutex=\"queue\"} 0\n"), std::string::npos);
+    EXPECT_EQ(text.find("# TYPE resource_pool_capacity gauge", 1), std::string::npos);
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+}
+
+TEST(openmetrics, histogram_bucket_le_should_include_samples_equal_to_it) {
+    histogram hold;
+    hold.record(std::chrono::nanoseconds(1023));
+    hold.record(std::chrono::nanoseconds(1024));
+    hold.record(std::chrono::nanoseconds(2048));
+    openmetrics::pool_snapshot snapshot;
+    snapshot.name = "pool";
+    snapshot.latency.hold = hold.snapshot();
+
+    std::array<char, 64 * 1024> buffer;
+    const std::string text(openmetrics::write(buffer.data(), buffer.size(), &snapshot, &snapshot + 1));
+
+    EXPECT_NE(text.find("resource_pool_hold_seconds_bucket{pool=\"pool\",le=\"1.023e-06\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_hold_seconds_bucket{pool=\"pool\",le=\"2.047e-06\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("resource_pool_hold_seconds_bucket{pool=\"pool\",le=\"4.095e-06\"} 3\n"), std::string::npos);
+    EXPECT_EQ(text.find("le=\"1.024e-06\""), std::string::npos);
+}
+
+TEST(openmetrics, write_to_small_buffer_should_return_empty_result) {
+    sync::pool<resource> pool(1);
+    std::array<char, 128> buffer;
+    EXPECT_TRUE(openmetrics::write(buffer.data(), buffer.size(), openmetrics::named("pool", pool)).empty());
+}
+
+}
@@ -0,0 +1,232 @@
+#include <yamail/resource_pool/sync/detail/fair_pool_impl.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+using namespace yamail::resource_pool::sync::detail;
+
+struct resource {
+    int value = 0;
+};
+
+using resource_pool_impl = fair_pool_impl<resource, std::mutex, std::condition_variable>;
+using get_result = resource_pool_impl::get_result;
+
+void wait_queue_size(const resource_pool_impl& pool, std::size_t value) {
+    while (pool.queue_size() != value) {
+        std::this_thread::yield();
+    }
+}
+
+struct sync_fair_resource_pool_impl : Test {};
+
+TEST(sync_fair_resource_pool_impl, create_with_zero_capacity_should_throw_exception) {
+    EXPECT_THROW(resource_pool_impl(0, time_traits::duration::max(), time_traits::duration::max()), error::zero_pool_capacity);
+}
+
+TEST(sync_fair_resource_pool_impl, create_then_check_stats_should_be_0_0_0) {
+    const resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const auto actual = pool.stats();
+
+    EXPECT_EQ(pool.capacity(), 1u);
+    EXPECT_EQ(actual.size, 0u);
+    EXPECT_EQ(actual.available, 0u);
+    EXPECT_EQ(actual.used, 0u);
+    EXPECT_EQ(pool.queue_size(), 0u);
+}
+
+TEST(sync_fair_resource_pool_impl, get_one_and_recycle_should_make_one_available_resource) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const get_result res = pool.get();
+    ASSERT_EQ(res.first, boost::system::error_code());
+    res.second->value = resource {42};
+    res.second->reset_time = time_traits::now();
+    pool.recycle(res.second);
+
+    EXPECT_EQ(pool.available(), 1u);
+    EXPECT_EQ(pool.used(), 0u);
+}
+
+TEST(sync_fair_resource_pool_impl, get_more_than_capacity_without_wait_should_return_error) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    pool.get();
+    EXPECT_EQ(pool.get().first, make_error_code(error::get_resource_timeout));
+}
+
+TEST(sync_fair_resource_pool_impl, get_more_than_capacity_with_wait_should_return_error_after_timeout) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    pool.get();
+    EXPECT_EQ(pool.get(std::chrono::milliseconds(1)).first, make_error_code(error::get_resource_timeout));
+    EXPECT_EQ(pool.queue_size(), 0u);
+}
+
+TEST(sync_fair_resource_pool_impl, get_after_disable_should_return_error) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    pool.disable();
+    EXPECT_EQ(pool.get().first, make_error_code(error::disabled));
+}
+
+TEST(sync_fair_resource_pool_impl, waiters_should_get_resource_in_fifo_order) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const get_result first = pool.get();
+    ASSERT_EQ(first.first, boost::system::error_code());
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    const auto wait = [&] (int id) {
+        const get_result res = pool.get(time_traits::duration::max());
+        EXPECT_EQ(res.first, boost::system::error_code());
+        {
+            const std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(id);
+        }
+        pool.recycle(res.second);
+    };
+
+    std::thread waiter1(wait, 1);
+    wait_queue_size(pool, 1);
+    std::thread waiter2(wait, 2);
+    wait_queue_size(pool, 2);
+
+    pool.recycle(first.second);
+
+    waiter1.join();
+    waiter2.join();
+
+    EXPECT_EQ(order, std::vector<int>({1, 2}));
+}
+
+TEST(sync_fair_resource_pool_impl, recycle_should_hand_resource_to_waiter_instead_of_new_request) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const get_result first = pool.get();
+    ASSERT_EQ(first.first, boost::system::error_code());
+    first.second->value = resource {42};
+    first.second->reset_time = time_traits::now();
+
+    get_result waited;
+    std::thread waiter([&] { waited = pool.get(time_traits::duration::max()); });
+    wait_queue_size(pool, 1);
+
+    pool.recycle(first.second);
+
+    EXPECT_EQ(pool.get().first, make_error_code(error::get_resource_timeout));
+
+    waiter.join();
+
+    ASSERT_EQ(waited.first, boost::system::error_code());
+    EXPECT_EQ(waited.second, first.second);
+    ASSERT_TRUE(waited.second->value);
+    EXPECT_EQ(waited.second->value->value, 42);
+}
+
+TEST(sync_fair_resource_pool_impl, waste_should_hand_empty_cell_to_waiter) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const get_result first = pool.get();
+    ASSERT_EQ(first.first, boost::system::error_code());
+    first.second->value = resource {42};
+
+    get_result waited;
+    std::thread waiter([&] { waited = pool.get(time_traits::duration::max()); });
+    wait_queue_size(pool, 1);
+
+    pool.waste(first.second);
+
+    waiter.join();
+
+    ASSERT_EQ(waited.first, boost::system::error_code());
+    EXPECT_FALSE(waited.second->value);
+}
+
+TEST(sync_fair_resource_pool_impl, disable_should_wake_up_waiters_with_error) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const get_result first = pool.get();
+    ASSERT_EQ(first.first, boost::system::error_code());
+
+    get_result waited;
+    std::thread waiter([&] { waited = pool.get(time_traits::duration::max()); });
+    wait_queue_size(pool, 1);
+
+    pool.disable();
+
+    waiter.join();
+
+    EXPECT_EQ(waited.first, make_error_code(error::disabled));
+    EXPECT_EQ(pool.queue_size(), 0u);
+}
+
+TEST(sync_fair_resource_pool_impl, should_waste_used_resource_after_invalidate_when_other_client_is_waiting) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const get_result first = pool.get();
+    ASSERT_EQ(first.first, boost::system::error_code());
+    first.second->value = resource {42};
+    first.second->reset_time = time_traits::now();
+    pool.invalidate();
+
+    get_result waited;
+    std::thread waiter([&] { waited = pool.get(time_traits::duration::max()); });
+    wait_queue_size(pool, 1);
+
+    pool.recycle(first.second);
+
+    waiter.join();
+
+    ASSERT_EQ(waited.first, boost::system::error_code());
+    EXPECT_FALSE(waited.second->value);
+}
+
+TEST(sync_fair_resource_pool_impl, create_with_adaptive_wait_should_keep_it) {
+    const resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max(),
+                                  sync::adaptive_wait {2, 4});
+    EXPECT_EQ(pool.wait().spins, 2u);
+    EXPECT_EQ(pool.wait().max_pause, 4u);
+}
+
+TEST(sync_fair_resource_pool_impl, get_with_adaptive_wait_should_receive_recycled_resource) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max(),
+                            sync::adaptive_wait {std::size_t(1) << 40, 1});
+    const get_result first = pool.get();
+    ASSERT_EQ(first.first, boost::system::error_code());
+
+    get_result waited;
+    std::thread waiter([&] { waited = pool.get(time_traits::duration::max()); });
+    wait_queue_size(pool, 1);
+
+    pool.recycle(first.second);
+
+    waiter.join();
+
+    EXPECT_EQ(waited.first, boost::system::error_code());
+    EXPECT_EQ(waited.second, first.second);
+}
+
+TEST(sync_fair_resource_pool_impl, concurrent_get_and_recycle_should_serve_every_waiter) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    std::atomic<std::size_t> served {0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 500; ++j) {
+                const get_result res = pool.get(time_traits::duration::max());
+                ASSERT_EQ(res.first, boost::system::error_code());
+                ++served;
+                pool.waste(res.second);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(served.load(), 2000u);
+    EXPECT_EQ(pool.used(), 0u);
+    EXPECT_EQ(pool.queue_size(), 0u);
+}
+
+}
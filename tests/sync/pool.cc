@@ -228,4 +228,20 @@ TEST_F(sync_resource_pool, get_auto_waste_handle_and_waste_should_call_waste_onc
     handle.waste();
 }
 
+TEST_F(sync_resource_pool, get_with_error_should_return_unusable_handle) {
+    const auto pool_impl = std::make_shared<StrictMock<mocked_pool_impl>>();
+    resource_pool pool(pool_impl);
+
+    InSequence s;
+
+    EXPECT_CALL(*pool_impl, get(_)).WillOnce(Return(mocked_pool_impl::get_result(
+        make_error_code(error::get_resource_timeout), resource_iterator)));
+    EXPECT_CALL(*pool_impl, disable()).WillOnce(Return());
+
+    const auto res = pool.get_auto_recycle();
+
+    EXPECT_EQ(res.first, make_error_code(error::get_resource_timeout));
+    EXPECT_TRUE(res.second.unusable());
+}
+
 }
@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <thread>
+
 namespace {
 
 using namespace testing;
@@ -16,7 +18,7 @@ struct resource {};
 struct mocked_condition_variable {
     MOCK_CONST_METHOD0(notify_one, void ());
     MOCK_CONST_METHOD0(notify_all, void ());
-    MOCK_CONST_METHOD2(wait_for, std::cv_status (std::unique_lock<std::mutex>&, time_traits::duration));
+    MOCK_CONST_METHOD2(wait_until, std::cv_status (std::unique_lock<std::mutex>&, time_traits::time_point));
 };
 
 using resource_pool_impl = pool_impl<resource, std::mutex, mocked_condition_variable>;
@@ -69,7 +71,7 @@ TEST(sync_resource_pool_impl, get_one_and_recycle_should_succeed) {
     resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
     const get_result res = pool_impl.get();
     EXPECT_EQ(res.first, boost::system::error_code());
-    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).WillOnce(Return());
+    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).Times(0);
     pool_impl.recycle(res.second);
 }
 
@@ -77,20 +79,20 @@ TEST(sync_resource_pool_impl, get_one_and_waste_should_succeed) {
     resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
     const get_result res = pool_impl.get();
     EXPECT_EQ(res.first, boost::system::error_code());
-    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).WillOnce(Return());
+    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).Times(0);
     pool_impl.waste(res.second);
 }
 
 TEST(sync_resource_pool_impl, get_more_than_capacity_returns_error) {
     resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
     pool_impl.get();
-    EXPECT_CALL(pool_impl.has_capacity(), wait_for(_, _)).WillOnce(Return(std::cv_status::timeout));
+    EXPECT_CALL(pool_impl.has_capacity(), wait_until(_, _)).WillOnce(Return(std::cv_status::timeout));
     EXPECT_EQ(pool_impl.get().first, make_error_code(error::get_resource_timeout));
 }
 
 TEST(sync_resource_pool_impl, get_after_disable_capacity_returns_error) {
     resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
-    EXPECT_CALL(pool_impl.has_capacity(), notify_all()).WillOnce(Return());
+    EXPECT_CALL(pool_impl.has_capacity(), notify_all()).Times(0);
     pool_impl.disable();
     EXPECT_EQ(pool_impl.get().first, make_error_code(error::disabled));
 }
@@ -105,7 +107,7 @@ struct handle_resource {
     handle_resource(resource_pool_impl& pool, resource_ptr_list_iterator res_it, strategy_type strategy)
         : pool(pool), res_it(res_it), strategy(strategy) {}
 
-    std::cv_status operator ()(std::unique_lock<std::mutex>& lock, time_traits::duration) const {
+    std::cv_status operator ()(std::unique_lock<std::mutex>& lock, time_traits::time_point) const {
         lock.unlock();
         (pool.*strategy)(res_it);
         lock.lock();
@@ -128,7 +130,7 @@ TEST(sync_resource_pool_impl, get_from_pool_and_wait_then_after_recycle_should_a
 
     InSequence s;
 
-    EXPECT_CALL(pool.has_capacity(), wait_for(_, _)).WillOnce(Invoke(recycle_resource(pool, first_res.second)));
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _)).WillOnce(Invoke(recycle_resource(pool, first_res.second)));
     EXPECT_CALL(pool.has_capacity(), notify_one()).WillOnce(Return());
 
     const get_result& second_res = pool.get();
@@ -150,7 +152,7 @@ TEST(sync_resource_pool_impl, get_from_pool_and_wait_then_after_waste_should_res
 
     InSequence s;
 
-    EXPECT_CALL(pool.has_capacity(), wait_for(_, _)).WillOnce(Invoke(waste_resource(pool, first_res.second)));
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _)).WillOnce(Invoke(waste_resource(pool, first_res.second)));
     EXPECT_CALL(pool.has_capacity(), notify_one()).WillOnce(Return());
 
     const get_result& second_res = pool.get();
@@ -163,7 +165,7 @@ struct disable_pool {
 
     disable_pool(resource_pool_impl& pool) : pool(pool) {}
 
-    std::cv_status operator ()(std::unique_lock<std::mutex>& lock, time_traits::duration) const {
+    std::cv_status operator ()(std::unique_lock<std::mutex>& lock, time_traits::time_point) const {
         lock.unlock();
         pool.disable();
         lock.lock();
@@ -179,7 +181,7 @@ TEST(sync_resource_pool_impl, get_from_pool_with_zero_capacity_then_disable_shou
 
     InSequence s;
 
-    EXPECT_CALL(pool.has_capacity(), wait_for(_, _)).WillOnce(Invoke(disable_pool(pool)));
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _)).WillOnce(Invoke(disable_pool(pool)));
     EXPECT_CALL(pool.has_capacity(), notify_all()).WillOnce(Return());
 
     const get_result& result = pool.get();
@@ -190,7 +192,7 @@ TEST(sync_resource_pool_impl, get_from_pool_with_zero_capacity_then_disable_shou
 TEST(sync_resource_pool_impl, get_one_set_and_recycle_with_zero_idle_timeout_then_get_should_return_empty) {
     resource_pool_impl pool_impl(1, time_traits::duration(0), time_traits::duration::max());
 
-    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).WillOnce(Return());
+    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).Times(0);
 
     const get_result first_res = pool_impl.get();
     EXPECT_EQ(first_res.first, boost::system::error_code());
@@ -209,7 +211,7 @@ TEST(sync_resource_pool_impl, get_one_set_and_recycle_with_zero_idle_timeout_the
 TEST(sync_resource_pool_impl, should_waste_resource_when_lifespan_ends) {
     resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration(0));
 
-    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).WillOnce(Return());
+    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).Times(0);
 
     const get_result first_res = pool_impl.get();
     EXPECT_EQ(first_res.first, boost::system::error_code());
@@ -224,7 +226,7 @@ TEST(sync_resource_pool_impl, should_waste_resource_when_lifespan_ends) {
 TEST(sync_resource_pool_impl, should_waste_used_resource_after_invalidate) {
     resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
 
-    EXPECT_CALL(pool.has_capacity(), notify_one()).WillOnce(Return());
+    EXPECT_CALL(pool.has_capacity(), notify_one()).Times(0);
 
     const get_result res = pool.get();
     EXPECT_EQ(res.first, boost::system::error_code());
@@ -251,8 +253,7 @@ TEST(sync_resource_pool_impl, should_restore_wasted_cell) {
 
     InSequence s;
 
-    EXPECT_CALL(pool.has_capacity(), notify_one()).WillOnce(Return());
-    EXPECT_CALL(pool.has_capacity(), notify_one()).WillOnce(Return());
+    EXPECT_CALL(pool.has_capacity(), notify_one()).Times(0);
 
     const get_result first_res = pool.get();
     EXPECT_EQ(first_res.first, boost::system::error_code());
@@ -279,7 +280,7 @@ TEST(sync_resource_pool_impl, should_waste_used_resource_after_invalidate_when_o
 
     InSequence s;
 
-    EXPECT_CALL(pool.has_capacity(), wait_for(_, _)).WillOnce(Invoke(recycle_resource(pool, first_res.second)));
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _)).WillOnce(Invoke(recycle_resource(pool, first_res.second)));
     EXPECT_CALL(pool.has_capacity(), notify_one()).WillOnce(Return());
 
     const get_result& second_res = pool.get();
@@ -288,4 +289,202 @@ TEST(sync_resource_pool_impl, should_waste_used_resource_after_invalidate_when_o
     EXPECT_EQ(second_res.second, first_res.second);
 }
 
+TEST(sync_resource_pool_impl, get_with_adaptive_wait_should_spin_before_wait_on_condition_variable) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max(),
+                            sync::adaptive_wait {std::size_t(1) << 40, 1});
+    const get_result first_res = pool.get();
+    ASSERT_EQ(first_res.first, boost::system::error_code());
+
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _)).Times(0);
+    EXPECT_CALL(pool.has_capacity(), notify_one()).Times(0);
+
+    std::thread recycler([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        pool.recycle(first_res.second);
+    });
+
+    const get_result second_res = pool.get(time_traits::duration::max());
+
+    recycler.join();
+
+    EXPECT_EQ(second_res.first, boost::system::error_code());
+    EXPECT_EQ(second_res.second, first_res.second);
+}
+
+TEST(sync_resource_pool_impl, get_with_adaptive_wait_should_wait_on_condition_variable_after_spin) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max(), sync::adaptive_wait {2, 4});
+    EXPECT_EQ(pool.wait().spins, 2u);
+    EXPECT_EQ(pool.wait().max_pause, 4u);
+    pool.get();
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _)).WillOnce(Return(std::cv_status::timeout));
+    EXPECT_EQ(pool.get(time_traits::duration(1)).first, make_error_code(error::get_resource_timeout));
+}
+
+TEST(sync_resource_pool_impl, get_with_adaptive_wait_should_include_spin_time_into_wait_duration) {
+    resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max(), sync::adaptive_wait {1000, 64});
+    pool.get();
+    const auto timeout = std::chrono::milliseconds(100);
+    const auto before = time_traits::now();
+    time_traits::time_point deadline;
+    time_traits::time_point parked_at;
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _))
+        .WillOnce(Invoke([&] (std::unique_lock<std::mutex>&, time_traits::time_point value) {
+            deadline = value;
+            parked_at = time_traits::now();
+            return std::cv_status::timeout;
+        }));
+    EXPECT_EQ(pool.get(timeout).first, make_error_code(error::get_resource_timeout));
+    EXPECT_GE(deadline, before + timeout);
+    EXPECT_LT(deadline, parked_at + timeout);
+}
+
+struct tracked_mutex {
+    static bool locked;
+
+    std::mutex impl;
+
+    void lock() {
+        impl.lock();
+        locked = true;
+    }
+
+    void unlock() {
+        locked = false;
+        impl.unlock();
+    }
+};
+
+bool tracked_mutex::locked = false;
+
+struct mocked_tracked_condition_variable {
+    MOCK_CONST_METHOD0(notify_one, void ());
+    MOCK_CONST_METHOD0(notify_all, void ());
+    MOCK_CONST_METHOD2(wait_until, std::cv_status (std::unique_lock<tracked_mutex>&, time_traits::time_point));
+};
+
+using tracked_resource_pool_impl = pool_impl<resource, tracked_mutex, mocked_tracked_condition_variable>;
+
+TEST(sync_resource_pool_impl, recycle_with_waiting_client_should_notify_without_lock) {
+    tracked_resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const auto first_res = pool.get();
+    ASSERT_EQ(first_res.first, boost::system::error_code());
+
+    InSequence s;
+
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _))
+        .WillOnce(Invoke([&] (std::unique_lock<tracked_mutex>& lock, time_traits::time_point) {
+            lock.unlock();
+            pool.recycle(first_res.second);
+            lock.lock();
+            return std::cv_status::no_timeout;
+        }));
+    EXPECT_CALL(pool.has_capacity(), notify_one()).WillOnce(Invoke([] { EXPECT_FALSE(tracked_mutex::locked); }));
+
+    const auto second_res = pool.get(time_traits::duration::max());
+
+    EXPECT_FALSE(second_res.first);
+    EXPECT_EQ(second_res.second, first_res.second);
+}
+
+TEST(sync_resource_pool_impl, disable_with_waiting_client_should_notify_all_without_lock) {
+    tracked_resource_pool_impl pool(1, time_traits::duration::max(), time_traits::duration::max());
+    const auto first_res = pool.get();
+    ASSERT_EQ(first_res.first, boost::system::error_code());
+
+    InSequence s;
+
+    EXPECT_CALL(pool.has_capacity(), wait_until(_, _))
+        .WillOnce(Invoke([&] (std::unique_lock<tracked_mutex>& lock, time_traits::time_point) {
+            lock.unlock();
+            pool.disable();
+            lock.lock();
+            return std::cv_status::no_timeout;
+        }));
+    EXPECT_CALL(pool.has_capacity(), notify_all()).WillOnce(Invoke([] { EXPECT_FALSE(tracked_mutex::locked); }));
+
+    EXPECT_EQ(pool.get(time_traits::duration::max()).first, make_error_code(error::disabled));
+}
+
+TEST(sync_resource_pool_impl, get_and_recycle_should_record_acquire_and_hold_latency) {
+    resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
+    const auto res = pool_impl.get();
+    ASSERT_EQ(res.first, boost::system::error_code());
+    pool_impl.recycle(res.second);
+
+    const auto latency = pool_impl.latency();
+    EXPECT_EQ(latency.acquire.count(), 1u);
+    EXPECT_EQ(latency.wait.count(), 0u);
+    EXPECT_EQ(latency.hold.count(), 1u);
+}
+
+TEST(sync_resource_pool_impl, get_after_wait_should_record_wait_latency) {
+    resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
+    const auto first_res = pool_impl.get();
+    ASSERT_EQ(first_res.first, boost::system::error_code());
+
+    EXPECT_CALL(pool_impl.has_capacity(), wait_until(_, _))
+        .WillOnce(Invoke([&] (std::unique_lock<std::mutex>& lock, time_traits::time_point) {
+            lock.unlock();
+            pool_impl.recycle(first_res.second);
+            lock.lock();
+            return std::cv_status::no_timeout;
+        }));
+    EXPECT_CALL(pool_impl.has_capacity(), notify_one()).WillOnce(Return());
+
+    const auto second_res = pool_impl.get(time_traits::duration::max());
+    ASSERT_EQ(second_res.first, boost::system::error_code());
+
+    const auto latency = pool_impl.latency();
+    EXPECT_EQ(latency.acquire.count(), 2u);
+    EXPECT_EQ(latency.wait.count(), 1u);
+    EXPECT_EQ(latency.hold.count(), 1u);
+}
+
+TEST(sync_resource_pool_impl, stats_should_count_empty_and_idle_leases) {
+    resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
+    auto res = pool_impl.get();
+    ASSERT_EQ(res.first, boost::system::error_code());
+    res.second->value = resource {};
+    pool_impl.recycle(res.second);
+    res = pool_impl.get();
+    ASSERT_EQ(res.first, boost::system::error_code());
+
+    const auto counters = pool_impl.stats().counters;
+    EXPECT_EQ(counters.empty_leases, 1u);
+    EXPECT_EQ(counters.idle_leases, 1u);
+}
+
+TEST(sync_resource_pool_impl, stats_should_count_invalidated_recycles_and_errors) {
+    resource_pool_impl pool_impl(1, time_traits::duration::max(), time_traits::duration::max());
+    const auto res = pool_impl.get();
+    ASSERT_EQ(res.first, boost::system::error_code());
+    EXPECT_CALL(pool_impl.has_capacity(), wait_until(_, _)).WillOnce(Return(std::cv_status::timeout));
+    EXPECT_EQ(pool_impl.get(time_traits::duration(1)).first, make_error_code(error::get_resource_timeout));
+    pool_impl.invalidate();
+    pool_impl.recycle(res.second);
+    pool_impl.disable();
+    EXPECT_EQ(pool_impl.get().first, make_error_code(error::disabled));
+
+    const auto counters = pool_impl.stats().counters;
+    EXPECT_EQ(counters.invalidated_recycles, 1u);
+    EXPECT_EQ(counters.get_resource_timeouts, 1u);
+    EXPECT_EQ(counters.disabled, 1u);
+    EXPECT_EQ(counters.request_queue_overflows, 0u);
+}
+
+TEST(sync_resource_pool_impl, stats_should_count_idle_timeout_and_lifespan_expirations) {
+    resource_pool_impl idle_pool(1, time_traits::duration(0), time_traits::duration::max());
+    auto res = idle_pool.get();
+    res.second->value = resource {};
+    idle_pool.recycle(res.second);
+    res = idle_pool.get();
+    EXPECT_EQ(idle_pool.stats().counters.idle_timeout_expirations, 1u);
+
+    resource_pool_impl lifespan_pool(1, time_traits::duration::max(), time_traits::duration(0));
+    res = lifespan_pool.get();
+    res.second->value = resource {};
+    lifespan_pool.recycle(res.second);
+    EXPECT_EQ(lifespan_pool.stats().counters.lifespan_expirations, 1u);
+}
+
 }
@@ -0,0 +1,122 @@
+#include <yamail/resource_pool/virtual_clock.hpp>
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using namespace testing;
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using boost::system::error_code;
+using std::chrono::minutes;
+using std::chrono::seconds;
+
+struct virtual_clock_test : Test {
+    void SetUp() override {
+        virtual_clock::reset();
+    }
+};
+
+TEST_F(virtual_clock_test, now_should_change_only_on_advance) {
+    const auto start = virtual_clock::now();
+    EXPECT_EQ(virtual_clock::now(), start);
+    virtual_clock::advance(minutes(1));
+    EXPECT_EQ(virtual_clock::now(), start + minutes(1));
+}
+
+TEST_F(virtual_clock_test, reset_should_set_now) {
+    virtual_clock::advance(minutes(1));
+    virtual_clock::reset(virtual_clock::time_point(seconds(42)));
+    EXPECT_EQ(virtual_clock::now(), virtual_clock::time_point(seconds(42)));
+}
+
+struct async_virtual_time_pool : virtual_clock_test {
+    using pool_t = async::timed_pool<int, virtual_time_traits>;
+
+    asio::io_context io;
+
+    pool_t::handle get(pool_t& pool) {
+        pool_t::handle result;
+        bool called = false;
+        pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle handle) {
+            EXPECT_FALSE(ec);
+            called = true;
+            result = std::move(handle);
+        });
+        io.restart();
+        io.poll();
+        EXPECT_TRUE(called);
+        return result;
+    }
+};
+
+TEST_F(async_virtual_time_pool, resource_should_expire_after_virtual_idle_timeout) {
+    pool_t pool(1, 1, minutes(1));
+    {
+        auto handle = get(pool);
+        ASSERT_TRUE(handle.empty());
+        handle.reset(42);
+    }
+    virtual_clock::advance(seconds(59));
+    {
+        auto handle = get(pool);
+        ASSERT_FALSE(handle.empty());
+        EXPECT_EQ(*handle, 42);
+    }
+    virtual_clock::advance(minutes(1));
+    EXPECT_TRUE(get(pool).empty());
+    EXPECT_EQ(pool.stats().counters.idle_timeout_expirations, 1u);
+}
+
+TEST_F(async_virtual_time_pool, resource_should_expire_after_virtual_lifespan) {
+    pool_t pool(1, 1, time_traits::duration::max(), minutes(10));
+    get(pool).reset(42);
+    for (int i = 0; i < 9; ++i) {
+        virtual_clock::advance(minutes(1));
+        EXPECT_FALSE(get(pool).empty());
+    }
+    virtual_clock::advance(minutes(1));
+    const auto handle = get(pool);
+    EXPECT_TRUE(handle.empty());
+    EXPECT_EQ(pool.stats().counters.lifespan_expirations, 1u);
+}
+
+TEST_F(async_virtual_time_pool, queued_requests_should_expire_at_virtual_deadlines) {
+    constexpr std::size_t waiters = 1000;
+    pool_t pool(1, waiters);
+    const auto held = get(pool);
+    std::size_t expired = 0;
+    for (std::size_t i = 1; i <= waiters; ++i) {
+        pool.get_auto_recycle(io, [&] (error_code ec, pool_t::handle) {
+            EXPECT_EQ(ec, error::get_resource_timeout);
+            ++expired;
+        }, seconds(i));
+    }
+    io.restart();
+    io.poll();
+    EXPECT_EQ(expired, 0u);
+    for (std::size_t step = 1; step <= 10; ++step) {
+        virtual_clock::advance(seconds(100));
+        io.restart();
+        io.poll();
+        EXPECT_EQ(expired, step * 100);
+    }
+    EXPECT_EQ(pool.stats().queue_size, 0u);
+    EXPECT_EQ(pool.stats().counters.get_resource_timeouts, waiters);
+}
+
+TEST_F(async_virtual_time_pool, hold_latency_should_use_virtual_time) {
+    pool_t pool(1, 1);
+    {
+        auto handle = get(pool);
+        handle.reset(42);
+        virtual_clock::advance(minutes(1));
+    }
+    EXPECT_EQ(pool.latency().hold.count(), 1u);
+    EXPECT_GE(pool.latency().hold.max(), minutes(1));
+}
+
+} // namespace
@@ -0,0 +1,89 @@
+#ifndef YAMAIL_RESOURCE_POOL_TOOLS_OPTIONS_HPP
+#define YAMAIL_RESOURCE_POOL_TOOLS_OPTIONS_HPP
+
+#include <yamail/resource_pool/time_traits.hpp>
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace options {
+
+using duration = yamail::resource_pool::time_traits::duration;
+
+// Parses "--name value" pairs.
+class parser {
+public:
+    parser(int argc, char* argv[]) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string name(argv[i]);
+            if (name.rfind("--", 0) != 0 || i + 1 >= argc) {
+                throw std::invalid_argument("expected --name value, got: " + name);
+            }
+            values_[name.substr(2)] = argv[++i];
+        }
+    }
+
+    bool has(const std::string& name) const {
+        return values_.count(name) != 0;
+    }
+
+    std::string get(const std::string& name, const std::string& default_value) const {
+        const auto it = values_.find(name);
+        return it == values_.end() ? default_value : it->second;
+    }
+
+private:
+    std::map<std::string, std::string> values_;
+};
+
+// Accepts integer with optional unit: ns, us, ms, s, m, h. Without unit value is in milliseconds. "inf" is max.
+inline duration parse_duration(const std::string& value) {
+    if (value == "inf") {
+        return duration::max();
+    }
+    std::size_t end = 0;
+    const auto number = std::stoll(value, &end);
+    const auto unit = value.substr(end);
+    if (unit == "ns") return std::chrono::nanoseconds(number);
+    if (unit == "us") return std::chrono::microseconds(number);
+    if (unit == "ms" || unit.empty()) return std::chrono::milliseconds(number);
+    if (unit == "s") return std::chrono::seconds(number);
+    if (unit == "m") return std::chrono::minutes(number);
+    if (unit == "h") return std::chrono::hours(number);
+    throw std::invalid_argument("invalid duration unit: " + value);
+}
+
+inline std::vector<std::string> split(const std::string& value) {
+    std::vector<std::string> result;
+    std::istringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        result.push_back(item);
+    }
+    return result;
+}
+
+inline std::string format_duration(duration value) {
+    if (value == duration::max()) {
+        return "inf";
+    }
+    std::ostringstream stream;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(value).count();
+    if (ns >= 1000000000) {
+        stream << static_cast<double>(ns) / 1e9 << "s";
+    } else if (ns >= 1000000) {
+        stream << static_cast<double>(ns) / 1e6 << "ms";
+    } else if (ns >= 1000) {
+        stream << static_cast<double>(ns) / 1e3 << "us";
+    } else {
+        stream << ns << "ns";
+    }
+    return stream.str();
+}
+
+} // namespace options
+
+#endif // YAMAIL_RESOURCE_POOL_TOOLS_OPTIONS_HPP
@@ -0,0 +1,114 @@
+#ifndef YAMAIL_RESOURCE_POOL_TOOLS_TRACE_HPP
+#define YAMAIL_RESOURCE_POOL_TOOLS_TRACE_HPP
+
+#include <yamail/resource_pool/time_traits.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace trace {
+
+using duration = yamail::resource_pool::time_traits::duration;
+
+struct record {
+    duration arrival;
+    duration hold;
+    duration wait_timeout;
+};
+
+// File starts with magic followed by records. Each record is three unsigned LEB128 numbers of nanoseconds:
+// arrival offset from previous record arrival, hold duration and wait timeout.
+constexpr char magic[] = "RPTRACE1";
+constexpr std::size_t magic_size = sizeof(magic) - 1;
+
+namespace detail {
+
+inline void write_varint(std::ostream& stream, std::uint64_t value) {
+    char buffer[10];
+    std::size_t size = 0;
+    do {
+        buffer[size] = static_cast<char>(value & 0x7f);
+        value >>= 7;
+        if (value != 0) {
+            buffer[size] = static_cast<char>(buffer[size] | 0x80);
+        }
+        ++size;
+    } while (value != 0);
+    stream.write(buffer, static_cast<std::streamsize>(size));
+}
+
+inline bool read_varint(std::istream& stream, std::uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const auto c = stream.get();
+        if (c == std::istream::traits_type::eof()) {
+            if (shift == 0) {
+                return false;
+            }
+            throw std::runtime_error("truncated trace record");
+        }
+        value |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+        if ((c & 0x80) == 0) {
+            return true;
+        }
+    }
+    throw std::runtime_error("invalid trace varint");
+}
+
+inline std::uint64_t to_count(duration value) {
+    if (value.count() < 0) {
+        throw std::invalid_argument("trace durations must be non-negative");
+    }
+    return static_cast<std::uint64_t>(value.count());
+}
+
+inline duration from_count(std::uint64_t value) {
+    return duration(static_cast<duration::rep>(value));
+}
+
+} // namespace detail
+
+inline void write(std::ostream& stream, const std::vector<record>& records) {
+    stream.write(magic, magic_size);
+    duration previous {0};
+    for (const auto& v : records) {
+        if (v.arrival < previous) {
+            throw std::invalid_argument("trace records must be ordered by arrival");
+        }
+        detail::write_varint(stream, detail::to_count(v.arrival - previous));
+        detail::write_varint(stream, detail::to_count(v.hold));
+        detail::write_varint(stream, detail::to_count(v.wait_timeout));
+        previous = v.arrival;
+    }
+    if (!stream) {
+        throw std::runtime_error("failed to write trace");
+    }
+}
+
+inline std::vector<record> read(std::istream& stream) {
+    char header[magic_size];
+    if (!stream.read(header, magic_size) || std::memcmp(header, magic, magic_size) != 0) {
+        throw std::runtime_error("not a resource pool trace");
+    }
+    std::vector<record> result;
+    duration arrival {0};
+    std::uint64_t delta = 0;
+    while (detail::read_varint(stream, delta)) {
+        std::uint64_t hold = 0;
+        std::uint64_t wait_timeout = 0;
+        if (!detail::read_varint(stream, hold) || !detail::read_varint(stream, wait_timeout)) {
+            throw std::runtime_error("truncated trace record");
+        }
+        arrival += detail::from_count(delta);
+        result.push_back(record {arrival, detail::from_count(hold), detail::from_count(wait_timeout)});
+    }
+    return result;
+}
+
+} // namespace trace
+
+#endif // YAMAIL_RESOURCE_POOL_TOOLS_TRACE_HPP
@@ -0,0 +1,131 @@
+#include "options.hpp"
+#include "trace.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace {
+
+using trace::duration;
+
+constexpr const char* usage = R"(Usage: resource_pool_trace_generate --output FILE [options]
+
+Options:
+    --requests N                 number of requests (default 100000)
+    --rate R                     arrival rate in requests per second outside bursts (default 1000)
+    --pattern poisson|bursty     arrival process (default poisson)
+    --burst-factor F             rate multiplier during bursts (default 10)
+    --burst-period DURATION      period of bursts (default 1s)
+    --burst-duty D               fraction of period covered by burst (default 0.1)
+    --hold DURATION              mean hold duration (default 10ms)
+    --hold-distribution exponential|constant (default exponential)
+    --timeout DURATION           wait timeout of each request (default 100ms)
+    --seed N                     random seed (default 1)
+
+Durations are integers with unit ns, us, ms, s, m or h.
+)";
+
+struct config {
+    std::size_t requests;
+    double rate;
+    bool bursty;
+    double burst_factor;
+    duration burst_period;
+    double burst_duty;
+    duration hold;
+    bool constant_hold;
+    duration timeout;
+    unsigned seed;
+};
+
+double seconds(duration value) {
+    return std::chrono::duration<double>(value).count();
+}
+
+duration from_seconds(double value) {
+    return std::chrono::duration_cast<duration>(std::chrono::duration<double>(value));
+}
+
+std::vector<trace::record> generate(const config& cfg) {
+    std::mt19937_64 engine(cfg.seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::exponential_distribution<double> hold(1.0 / seconds(cfg.hold));
+    const double max_rate = cfg.bursty ? cfg.rate * cfg.burst_factor : cfg.rate;
+    std::exponential_distribution<double> interval(max_rate);
+    const auto rate = [&] (double t) {
+        if (!cfg.bursty) {
+            return cfg.rate;
+        }
+        const double period = seconds(cfg.burst_period);
+        const double phase = t - period * std::floor(t / period);
+        return phase < period * cfg.burst_duty ? max_rate : cfg.rate;
+    };
+
+    std::vector<trace::record> result;
+    result.reserve(cfg.requests);
+    double t = 0;
+    while (result.size() < cfg.requests) {
+        // Thinning of homogeneous process with max rate gives nonhomogeneous Poisson process.
+        t += interval(engine);
+        if (uniform(engine) * max_rate > rate(t)) {
+            continue;
+        }
+        result.push_back(trace::record {
+            from_seconds(t),
+            cfg.constant_hold ? cfg.hold : from_seconds(hold(engine)),
+            cfg.timeout,
+        });
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const options::parser args(argc, argv);
+        if (!args.has("output")) {
+            std::cerr << usage;
+            return 1;
+        }
+        const auto pattern = args.get("pattern", "poisson");
+        const auto hold_distribution = args.get("hold-distribution", "exponential");
+        if (pattern != "poisson" && pattern != "bursty") {
+            throw std::invalid_argument("invalid pattern: " + pattern);
+        }
+        if (hold_distribution != "exponential" && hold_distribution != "constant") {
+            throw std::invalid_argument("invalid hold distribution: " + hold_distribution);
+        }
+        const config cfg {
+            std::stoul(args.get("requests", "100000")),
+            std::stod(args.get("rate", "1000")),
+            pattern == "bursty",
+            std::stod(args.get("burst-factor", "10")),
+            options::parse_duration(args.get("burst-period", "1s")),
+            std::stod(args.get("burst-duty", "0.1")),
+            options::parse_duration(args.get("hold", "10ms")),
+            hold_distribution == "constant",
+            options::parse_duration(args.get("timeout", "100ms")),
+            static_cast<unsigned>(std::stoul(args.get("seed", "1"))),
+        };
+        if (cfg.rate <= 0 || cfg.burst_factor < 1 || cfg.burst_duty < 0 || cfg.burst_duty > 1
+                || cfg.hold <= duration::zero()) {
+            throw std::invalid_argument("rate, hold must be positive, burst factor >= 1, burst duty in [0, 1]");
+        }
+        const auto records = generate(cfg);
+        std::ofstream output(args.get("output", ""), std::ios::binary);
+        if (!output) {
+            throw std::runtime_error("failed to open output: " + args.get("output", ""));
+        }
+        trace::write(output, records);
+        std::cerr << "generated " << records.size() << " requests over "
+                  << options::format_duration(records.empty() ? duration::zero() : records.back().arrival)
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl << usage;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "options.hpp"
+#include "trace.hpp"
+
+#include <yamail/resource_pool/async/pool.hpp>
+#include <yamail/resource_pool/histogram.hpp>
+#include <yamail/resource_pool/virtual_clock.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+using namespace yamail::resource_pool;
+
+namespace asio = boost::asio;
+
+using boost::system::error_code;
+using trace::duration;
+
+using pool_t = async::timed_pool<int, virtual_time_traits>;
+
+constexpr const char* usage = R"(Usage: resource_pool_trace_replay --trace FILE [options]
+
+Options:
+    --capacity LIST              comma separated pool capacities (default 10)
+    --queue-capacity LIST        comma separated queue capacities (default 1000)
+    --idle-timeout LIST          comma separated idle timeouts (default inf)
+
+Replays each combination of options on virtual clock and prints one row per combination.
+Durations are integers with unit ns, us, ms, s, m or h, or inf.
+)";
+
+struct config {
+    std::size_t capacity;
+    std::size_t queue_capacity;
+    duration idle_timeout;
+};
+
+struct result {
+    std::size_t served = 0;
+    std::size_t timeouts = 0;
+    std::size_t overflows = 0;
+    std::size_t errors = 0;
+    std::size_t max_queue_size = 0;
+    double utilisation = 0;
+    pool_counters counters;
+    histogram_snapshot wait;
+};
+
+struct release {
+    duration at;
+    pool_t::handle handle;
+};
+
+bool operator >(const release& lhs, const release& rhs) {
+    return lhs.at > rhs.at;
+}
+
+result replay(const std::vector<trace::record>& records, const config& cfg) {
+    virtual_clock::reset();
+    asio::io_context io;
+    pool_t pool(cfg.capacity, cfg.queue_capacity, cfg.idle_timeout);
+    histogram wait;
+    result r;
+    std::vector<release> releases;
+    duration now {0};
+    double busy = 0;
+
+    const auto poll = [&] {
+        io.restart();
+        io.poll();
+        r.max_queue_size = std::max(r.max_queue_size, pool.stats().queue_size);
+    };
+    const auto advance = [&] (duration to) {
+        if (to <= now) {
+            return;
+        }
+        busy += static_cast<double>(pool.used()) * std::chrono::duration<double>(to - now).count();
+        virtual_clock::advance(to - now);
+        now = to;
+        // Expired waiters are cancelled before events at the same moment are handled.
+        poll();
+    };
+
+    auto request = records.begin();
+    while (request != records.end() || !releases.empty()) {
+        if (!releases.empty() && (request == records.end() || releases.front().at <= request->arrival)) {
+            advance(releases.front().at);
+            std::pop_heap(releases.begin(), releases.end(), std::greater<>());
+            auto handle = std::move(releases.back().handle);
+            releases.pop_back();
+            handle.recycle();
+        } else {
+            advance(request->arrival);
+            const auto arrival = request->arrival;
+            const auto hold = request->hold;
+            pool.get_auto_recycle(io, [&, arrival, hold] (error_code ec, pool_t::handle handle) {
+                if (ec == error::get_resource_timeout) {
+                    ++r.timeouts;
+                } else if (ec == error::request_queue_overflow) {
+                    ++r.overflows;
+                } else if (ec) {
+                    ++r.errors;
+                } else {
+                    if (handle.empty()) {
+                        handle.reset(0);
+                    }
+                    ++r.served;
+                    wait.record(now - arrival);
+                    releases.push_back(release {now + hold, std::move(handle)});
+                    std::push_heap(releases.begin(), releases.end(), std::greater<>());
+                }
+            }, request->wait_timeout);
+            ++request;
+        }
+        poll();
+    }
+
+    r.utilisation = now > duration::zero()
+        ? busy / (static_cast<double>(cfg.capacity) * std::chrono::duration<double>(now).count())
+        : 0;
+    r.counters = pool.stats().counters;
+    r.wait = wait.snapshot();
+    return r;
+}
+
+template <class T, class Parse>
+std::vector<T> parse_list(const std::string& value, Parse parse) {
+    std::vector<T> result;
+    for (const auto& item : options::split(value)) {
+        result.push_back(parse(item));
+    }
+    if (result.empty()) {
+        throw std::invalid_argument("empty list");
+    }
+    return result;
+}
+
+std::size_t parse_size(const std::string& value) {
+    return std::stoul(value);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const options::parser args(argc, argv);
+        if (!args.has("trace")) {
+            std::cerr << usage;
+            return 1;
+        }
+        std::ifstream input(args.get("trace", ""), std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("failed to open trace: " + args.get("trace", ""));
+        }
+        const auto records = trace::read(input);
+        const auto capacities = parse_list<std::size_t>(args.get("capacity", "10"), parse_size);
+        const auto queue_capacities = parse_list<std::size_t>(args.get("queue-capacity", "1000"), parse_size);
+        const auto idle_timeouts = parse_list<duration>(args.get("idle-timeout", "inf"), options::parse_duration);
+
+        std::cout << std::left
+                  << std::setw(10) << "capacity" << std::setw(16) << "queue_capacity" << std::setw(14) << "idle_timeout"
+                  << std::setw(10) << "requests" << std::setw(10) << "served" << std::setw(10) << "timeouts"
+                  << std::setw(11) << "overflows" << std::setw(11) << "wait_p50" << std::setw(11) << "wait_p90"
+                  << std::setw(11) << "wait_p99" << std::setw(11) << "wait_max" << std::setw(13) << "utilisation"
+                  << std::setw(10) << "created" << std::setw(14) << "idle_expired" << "max_queue" << std::endl;
+        for (const auto capacity : capacities) {
+            for (const auto queue_capacity : queue_capacities) {
+                for (const auto idle_timeout : idle_timeouts) {
+                    const auto r = replay(records, config {capacity, queue_capacity, idle_timeout});
+                    std::cout << std::setw(10) << capacity << std::setw(16) << queue_capacity
+                              << std::setw(14) << options::format_duration(idle_timeout)
+                              << std::setw(10) << records.size() << std::setw(10) << r.served
+                              << std::setw(10) << r.timeouts << std::setw(11) << r.overflows
+                              << std::setw(11) << options::format_duration(r.wait.percentile(0.5))
+                              << std::setw(11) << options::format_duration(r.wait.percentile(0.9))
+                              << std::setw(11) << options::format_duration(r.wait.percentile(0.99))
+                              << std::setw(11) << options::format_duration(r.wait.max())
+                              << std::setw(13) << std::fixed << std::setprecision(3) << r.utilisation
+                              << std::defaultfloat << std::setprecision(6)
+                              << std::setw(10) << r.counters.empty_leases
+                              << std::setw(14) << r.counters.idle_timeout_expirations
+                              << r.max_queue_size << std::endl;
+                    if (r.errors) {
+                        std::cerr << "unexpected errors: " << r.errors << std::endl;
+                    }
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl << usage;
+        return 1;
+    }
+    return 0;
+}